@@ -3,13 +3,23 @@
 
 #include <string>
 #include <cstdint>
+#include <unordered_map>
 
 #include "encoding.hpp"
+#include "unicode_bidi.hpp"
+#include "unicode_collation.hpp"
+#include "unicode_confusables.hpp"
 
 namespace todo {
 
 	static int counter = 0;
 
+	// every title an item is given has a number of its own
+	inline uint64_t get_next_title_version() {
+		static uint64_t next = 0;
+		return ++next;
+	}
+
 	enum class Priority : int8_t {
 		LOWEST  = -3,
 		LOWER   = -2,
@@ -35,11 +45,127 @@ namespace todo {
 		public:
 			Priority priority = Priority::DEFAULT;
 			Status status = Status::DEFAULT;
-			Unicode::string_t title = encoding::decode_literal((std::string) "New Item " + std::to_string(counter++));
 
 			Item() {}
+			explicit Item(const Unicode::string_t& title) : title(title) {}
+
+			const Unicode::string_t& get_title() const { return title; }
+
+			// Changes whenever the title does, and no two different titles
+			// share one, so it can stand in for the title as a cache key.
+			// A copy of an item has the same title, and the same version.
+			uint64_t get_title_version() const { return title_version; }
+
+			void set_title(const Unicode::string_t& new_title) {
+				title = new_title;
+				title_version = get_next_title_version();
+				sort_key_valid = false;
+				bidi_valid = false;
+				visual_title_valid = false;
+				skeleton_valid = false;
+			}
+
+			// The collation sort key of the title, so that sorting items
+			// only compares bytes. It is computed on first use, and again
+			// after the title changes.
+			const Unicode::sort_key_t& get_sort_key() const {
+				if (!sort_key_valid) {
+					sort_key = Unicode::get_sort_key(title);
+					sort_key_valid = true;
+				}
+				return sort_key;
+			}
+
+			// The resolved bidi levels of the title, cached the same way, so
+			// that painting a row only reorders it. Titles without any RTL
+			// text are recognized with one table scan and store no levels.
+			const Unicode::BidiParagraph& get_bidi_paragraph() const {
+				if (!bidi_valid) {
+					bidi = Unicode::BidiParagraph(title);
+					bidi_valid = true;
+				}
+				return bidi;
+			}
+
+			// The title in the order it is painted, cached the same way.
+			// Titles without RTL text are painted as they are.
+			const Unicode::string_t& get_visual_title() const {
+				const Unicode::BidiParagraph& paragraph = get_bidi_paragraph();
+				if (paragraph.is_ltr()) return title;
+
+				if (!visual_title_valid) {
+					visual_title = Unicode::reorder_visually(title, paragraph);
+					visual_title_valid = true;
+				}
+				return visual_title;
+			}
+
+			// The confusable skeleton of the title, cached the same way, so
+			// that titles which only differ in homoglyphs can be found by
+			// hashing.
+			const Unicode::string_t& get_skeleton() const {
+				if (!skeleton_valid) {
+					skeleton = Unicode::get_skeleton(title);
+					skeleton_valid = true;
+				}
+				return skeleton;
+			}
+
+		private:
+			Unicode::string_t title = encoding::decode_literal((std::string) "New Item " + std::to_string(counter++));
+			uint64_t title_version = get_next_title_version();
+
+			mutable Unicode::sort_key_t sort_key;
+			mutable bool sort_key_valid = false;
+
+			mutable Unicode::BidiParagraph bidi;
+			mutable bool bidi_valid = false;
+
+			mutable Unicode::string_t visual_title;
+			mutable bool visual_title_valid = false;
+
+			mutable Unicode::string_t skeleton;
+			mutable bool skeleton_valid = false;
+	};
+
+	// Counts the items by the skeleton of their title, so that finding out
+	// whether a title looks like another one takes a hash lookup instead of
+	// comparing it with every item. Items must be removed with the title
+	// they were added with.
+	class SkeletonIndex {
+		public:
+			void add(const Item& item) {
+				counts[item.get_skeleton()]++;
+			}
+
+			void remove(const Item& item) {
+				auto it = counts.find(item.get_skeleton());
+				if (it == counts.end()) return;
+				if (--it->second == 0) counts.erase(it);
+			}
+
+			// how many items have a title that looks like this one
+			size_t count(const Unicode::string_t& skeleton) const {
+				auto it = counts.find(skeleton);
+				return it == counts.end() ? 0 : it->second;
+			}
+
+			// whether another item looks like this one, which is in the index
+			bool has_duplicate(const Item& item) const {
+				return count(item.get_skeleton()) > 1;
+			}
+
+			void clear() { counts.clear(); }
+
+		private:
+			std::unordered_map<Unicode::string_t, size_t> counts;
 	};
 
+	// orders items by title, for std::sort
+	inline bool compare_titles(const Item& a, const Item& b) {
+		return a.get_sort_key() < b.get_sort_key();
+	}
+
 	const char* to_string(const Priority &p);
 	const char* to_string(const Status &p);
 
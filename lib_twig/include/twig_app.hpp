@@ -3,6 +3,10 @@
 
 #include "twig_constants.hpp"
 #include "twig_widget.hpp"
+#include "twig_event_loop.hpp"
+#include "twig_input.hpp"
+
+#include <vector>
 
 namespace twig {
 
@@ -15,10 +19,60 @@ namespace twig {
 			virtual void when_typed(const Unicode::codepoint_t& input) {}
 			virtual void when_typed_special(const special_key& key) {}
 
+			// Called with all of a paste at once, which the terminal marks
+			// in bracketed paste mode. By default it is typed codepoint by
+			// codepoint.
+			virtual void when_pasted(const Unicode::string_t& text) {
+				for (const Unicode::codepoint_t codepoint : text) {
+					when_typed(codepoint);
+				}
+			}
+
+			// Called with all the keys that came in at once, e.g. while a
+			// key is held down. By default they go to when_typed,
+			// when_typed_special and when_pasted one by one.
+			virtual void when_input(const std::vector<input::KeyEvent>& keys) {
+				for (const input::KeyEvent& key : keys) {
+					switch (key.type) {
+						case input::KeyEvent::Type::TYPED:
+							when_typed(key.codepoint);
+							break;
+						case input::KeyEvent::Type::SPECIAL:
+							when_typed_special(key.key);
+							break;
+						case input::KeyEvent::Type::PASTED:
+							when_pasted(key.text);
+							break;
+					}
+				}
+			}
+
+			// called whenever nothing has happened for the idle timeout
 			virtual void when_no_event() {}
 
+			// in milliseconds, or negative to never call when_no_event
+			virtual int get_idle_timeout() { return 1000; }
+
+			// the most repaints in a second, see twig::FrameScheduler
+			virtual unsigned int get_max_fps() { return 60; }
+
+			// How long to wait after an ESC, in milliseconds, for the rest
+			// of an escape sequence before it is taken as the escape key
+			virtual int get_escape_timeout() { return 25; }
+
+			// How long to wait, in milliseconds, for more of a paste that
+			// stopped before its end, which may never come
+			virtual int get_paste_timeout() { return 1000; }
+
+			// for timers, and for other threads to get work done on the
+			// UI thread, which is then repainted
+			EventLoop& get_event_loop() { return event_loop; }
+
 			virtual void when_starting() {}
 			virtual void when_exiting() {}
+
+		private:
+			EventLoop event_loop;
 	};
 
 	namespace curses {
@@ -30,6 +84,18 @@ namespace twig {
 
 	}
 
+	// the backend of twig_terminal.hpp, which does not use ncurses
+	namespace term {
+
+		void init();
+		void exit();
+
+		bool is_in_app_mode();
+
+		int run_twig_app(TwigApp *app);
+
+	}
+
 };
 
 #endif
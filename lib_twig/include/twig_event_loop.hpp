@@ -0,0 +1,69 @@
+#ifndef INCLUDED_TWIG_EVENT_LOOP_HPP
+#define INCLUDED_TWIG_EVENT_LOOP_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace twig {
+
+	// Waits for input, timers and wakeups from other threads all at once,
+	// so that the runners can handle everything that happened before they
+	// repaint.
+	class EventLoop {
+		public:
+			typedef std::function<void()> Callback;
+			typedef int TimerId;
+
+			EventLoop();
+			~EventLoop();
+
+			EventLoop(const EventLoop&) = delete;
+			EventLoop& operator=(const EventLoop&) = delete;
+
+			// calls when_ready whenever fd can be read from
+			void watch(int fd, Callback when_ready);
+			void unwatch(int fd);
+
+			// Calls fn after delay, and then every interval, unless the
+			// interval is zero. Timers can be removed from inside fn.
+			TimerId add_timer(
+					std::chrono::milliseconds delay,
+					std::chrono::milliseconds interval,
+					Callback fn);
+
+			void remove_timer(TimerId id);
+
+			// Runs fn on the thread of the loop, from any thread
+			void post(Callback fn);
+
+			// Makes run_once return early, from any thread, or from a
+			// signal handler
+			void wake();
+
+			// Waits up to timeout_ms for something to happen, or forever if
+			// it is negative, and handles everything that did. Returns
+			// whether anything did.
+			bool run_once(int timeout_ms);
+
+		private:
+			int epoll_fd;
+			int wake_fd;
+
+			std::unordered_map<int, Callback> watched;
+			std::unordered_map<TimerId, bool> timer_repeats;
+
+			std::mutex posted_mutex;
+			std::vector<Callback> posted;
+
+			// swapped with posted, so that running them needs no lock
+			std::vector<Callback> running;
+
+			void run_posted();
+	};
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef INCLUDED_TWIG_FRAME_SCHEDULER_HPP
+#define INCLUDED_TWIG_FRAME_SCHEDULER_HPP
+
+#include <algorithm>
+#include <chrono>
+
+#include <cassert>
+
+namespace twig {
+
+	// Decides when the runners repaint: at most max_fps times a second,
+	// however many changes and resizes come in between, which are painted
+	// together. After a quiet period the next frame is painted right away,
+	// so a key pressed after a pause shows up without a delay.
+	class FrameScheduler {
+		public:
+			typedef std::chrono::steady_clock Clock;
+
+			FrameScheduler(unsigned int max_fps = 60) {
+				set_max_fps(max_fps);
+			}
+
+			void set_max_fps(unsigned int max_fps) {
+				assert(max_fps > 0);
+				interval = std::chrono::duration_cast<Clock::duration>(
+						std::chrono::seconds(1)) / max_fps;
+			}
+
+			// whether a frame may be painted now
+			bool is_due(Clock::time_point now = Clock::now()) const {
+				return now - last_frame >= interval;
+			}
+
+			// called once a frame was painted
+			void painted(Clock::time_point now = Clock::now()) {
+				last_frame = now;
+			}
+
+			// How long to wait for events, in milliseconds: with a frame
+			// pending, until it is due, otherwise for timeout_ms, which is
+			// negative for ever.
+			int get_wait_timeout(
+					bool pending,
+					int timeout_ms,
+					Clock::time_point now = Clock::now()) const {
+
+				if (!pending) return timeout_ms;
+
+				const Clock::duration left = last_frame + interval - now;
+				if (left <= Clock::duration::zero()) return 0;
+
+				// rounded up, so the frame is due once the wait is over
+				const int left_ms = std::chrono::ceil<std::chrono::milliseconds>(left).count();
+				return timeout_ms < 0 ? left_ms : std::min(left_ms, timeout_ms);
+			}
+
+		private:
+			Clock::duration interval;
+			Clock::time_point last_frame;
+	};
+
+}
+
+#endif
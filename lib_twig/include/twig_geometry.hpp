@@ -1,6 +1,7 @@
 #ifndef INCLUDED_TWIG_GEOMETRY_HPP
 #define INCLUDED_TWIG_GEOMETRY_HPP
 
+#include <algorithm>
 #include <cmath>
 
 namespace twig::geom {
@@ -101,6 +102,49 @@ namespace twig::geom {
 			return width == 0 || height == 0;
 		}
 
+		// whether the two overlap, which an empty rectangle never does
+		bool intersects(const Rectangle<T>& o) const {
+			return !is_zero() && !o.is_zero()
+				&& x < o.x + o.width && o.x < x + width
+				&& y < o.y + o.height && o.y < y + height;
+		}
+
+		// whether the two overlap or share an edge
+		bool touches(const Rectangle<T>& o) const {
+			return !is_zero() && !o.is_zero()
+				&& x <= o.x + o.width && o.x <= x + width
+				&& y <= o.y + o.height && o.y <= y + height;
+		}
+
+		bool contains(const Rectangle<T>& o) const {
+			return o.is_zero() || (
+				x <= o.x && o.x + o.width <= x + width
+				&& y <= o.y && o.y + o.height <= y + height);
+		}
+
+		// the smallest rectangle that contains both
+		Rectangle<T> bounding_union(const Rectangle<T>& o) const {
+			if (is_zero()) return o;
+			if (o.is_zero()) return *this;
+
+			const T left = std::min(x, o.x);
+			const T top = std::min(y, o.y);
+			const T right = std::max(x + width, o.x + o.width);
+			const T bottom = std::max(y + height, o.y + o.height);
+			return { left, top, (T) (right - left), (T) (bottom - top) };
+		}
+
+		// the part of this that is inside o, which may be empty
+		Rectangle<T> intersection(const Rectangle<T>& o) const {
+			if (!intersects(o)) return { x, y, 0, 0 };
+
+			const T left = std::max(x, o.x);
+			const T top = std::max(y, o.y);
+			const T right = std::min(x + width, o.x + o.width);
+			const T bottom = std::min(y + height, o.y + o.height);
+			return { left, top, (T) (right - left), (T) (bottom - top) };
+		}
+
 		bool operator==(const Rectangle<T>& o) const {
 			return x == o.x
 				&& y == o.y
@@ -0,0 +1,190 @@
+#ifndef INCLUDED_TWIG_INPUT_HPP
+#define INCLUDED_TWIG_INPUT_HPP
+
+#include "twig_constants.hpp"
+#include "twig_event_loop.hpp"
+
+#include "unicode.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace twig {
+	class TwigApp;
+}
+
+namespace twig::input {
+
+	struct KeyEvent {
+		enum class Type : uint8_t {
+			TYPED,
+			SPECIAL,
+			PASTED
+		};
+
+		Type type;
+		Unicode::codepoint_t codepoint;
+		special_key key;
+
+		// all of a bracketed paste
+		Unicode::string_t text;
+
+		static KeyEvent typed(Unicode::codepoint_t codepoint) {
+			return { Type::TYPED, codepoint, special_key::OTHER, {} };
+		}
+
+		static KeyEvent special(special_key key) {
+			return { Type::SPECIAL, 0, key, {} };
+		}
+
+		static KeyEvent pasted(Unicode::string_t&& text) {
+			return { Type::PASTED, 0, special_key::OTHER, std::move(text) };
+		}
+	};
+
+	// UTF-8, a byte at a time, with U+FFFD for anything that is not valid
+	class Utf8Decoder {
+		public:
+			// calls emit with each codepoint that b finishes
+			template<typename F> void feed(unsigned char b, F emit) {
+				if (remaining > 0) {
+					if ((b & 0xC0) == 0x80) {
+						codepoint = (codepoint << 6) | (b & 0x3F);
+						if (--remaining > 0) return;
+
+						const bool valid = codepoint >= min_codepoint
+							&& codepoint <= 0x10FFFF
+							&& !(codepoint >= 0xD800 && codepoint <= 0xDFFF);
+						emit(valid ? codepoint : 0xFFFD);
+						return;
+					}
+
+					// cut off, and b starts something else
+					remaining = 0;
+					emit(0xFFFD);
+				}
+
+				if (b < 0x80) {
+					emit(b);
+				} else if ((b & 0xE0) == 0xC0) {
+					start(b & 0x1F, 0x80, 1);
+				} else if ((b & 0xF0) == 0xE0) {
+					start(b & 0x0F, 0x800, 2);
+				} else if ((b & 0xF8) == 0xF0) {
+					start(b & 0x07, 0x10000, 3);
+				} else {
+					emit(0xFFFD);
+				}
+			}
+
+		private:
+			Unicode::codepoint_t codepoint = 0;
+			Unicode::codepoint_t min_codepoint = 0;
+			uint8_t remaining = 0;
+
+			void start(Unicode::codepoint_t first_bits, Unicode::codepoint_t min, uint8_t continuations) {
+				codepoint = first_bits;
+				min_codepoint = min;
+				remaining = continuations;
+			}
+	};
+
+	// Turns the bytes a terminal sends into keys: UTF-8 into codepoints,
+	// and CSI and SS3 sequences into special keys. Bytes can come in any
+	// chunks, since a sequence that is cut off is finished by the next.
+	// Bracketed pastes come out whole, as one event.
+	class InputParser {
+		public:
+			// appends the keys of bytes to out
+			void feed(const char* bytes, size_t len, std::vector<KeyEvent>& out);
+
+			// Whether an ESC is held back, because it may start an escape
+			// sequence. The escape key sends a lone ESC, so if nothing
+			// follows soon, flush should be called.
+			bool has_pending() const {
+				return !escape.empty();
+			}
+
+			// Whether a paste has started and not ended yet. If its end
+			// never comes, flush should be called after a while, so that
+			// the input after it is not taken as part of it.
+			bool is_pasting() const {
+				return in_paste;
+			}
+
+			// Gives up on the escape sequence, so that the ESC is the
+			// escape key, and what came after it was typed as it is. A
+			// paste that has not ended yet is given as it is, too.
+			void flush(std::vector<KeyEvent>& out);
+
+		private:
+			Utf8Decoder decoder;
+
+			// the escape sequence so far, starting with ESC
+			std::string escape;
+
+			// inside a bracketed paste, everything up to the end of it
+			bool in_paste = false;
+			Utf8Decoder paste_decoder;
+			Unicode::string_t paste;
+
+			void feed_paste(unsigned char b, std::vector<KeyEvent>& out);
+
+			// anything longer is not a key, and is dropped up to its
+			// final byte
+			static constexpr size_t MAX_ESCAPE_LEN = 32;
+			bool escape_too_long = false;
+
+			void feed_escape(char c, std::vector<KeyEvent>& out);
+			void feed_byte(unsigned char b, std::vector<KeyEvent>& out);
+	};
+
+	// Reads everything there is from fd at once, and hands the keys to the
+	// app in one batch, see TwigApp::when_input. A lone ESC is held back for
+	// the escape timeout, and a paste that stops before its end for the
+	// paste timeout, both of which run on the event loop. The fd stays
+	// blocking, since a tty shares that flag with the output.
+	class InputReader {
+		public:
+			InputReader(int fd, TwigApp *app, EventLoop& events) :
+				fd(fd), app(app), events(events) {}
+
+			~InputReader();
+
+			void set_escape_timeout(std::chrono::milliseconds timeout) {
+				escape_timeout = timeout;
+			}
+
+			void set_paste_timeout(std::chrono::milliseconds timeout) {
+				paste_timeout = timeout;
+			}
+
+			// returns false once the fd is at its end
+			bool read_available();
+
+		private:
+			const int fd;
+			TwigApp* const app;
+			EventLoop& events;
+
+			InputParser parser;
+			std::chrono::milliseconds escape_timeout { 25 };
+			std::chrono::milliseconds paste_timeout { 1000 };
+
+			// reused, so reading does not allocate
+			std::vector<KeyEvent> keys;
+
+			// flushes the parser, when it waited for too long
+			bool flush_timer_set = false;
+			EventLoop::TimerId flush_timer;
+
+			void cancel_flush_timer();
+			void dispatch();
+	};
+
+}
+
+#endif
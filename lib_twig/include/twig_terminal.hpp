@@ -0,0 +1,214 @@
+#ifndef INCLUDED_TWIG_TERMINAL_HPP
+#define INCLUDED_TWIG_TERMINAL_HPP
+
+#include "twig_widget.hpp"
+#include "twig_color.hpp"
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstring>
+
+// A terminal backend that does not go through ncurses. Widgets paint into
+// a grid of cells, which is compared to the grid that is on the screen, and
+// only the cells that differ are sent to the terminal, all at once.
+
+namespace twig::term {
+
+	using twig::widget::WInt;
+	using twig::widget::WDim;
+	using twig::widget::WPoint;
+	using twig::widget::WRect;
+
+	namespace Attr {
+		constexpr uint16_t BOLD      = 1 << 0;
+		constexpr uint16_t DIM       = 1 << 1;
+		constexpr uint16_t ITALIC    = 1 << 2;
+		constexpr uint16_t UNDERLINE = 1 << 3;
+		constexpr uint16_t BLINK     = 1 << 4;
+		constexpr uint16_t REVERSE   = 1 << 5;
+		constexpr uint16_t STANDOUT  = 1 << 6;
+		constexpr uint16_t INVISIBLE = 1 << 7;
+	};
+
+	// One column of the terminal, holding a whole grapheme cluster
+	struct Cell {
+		// long enough for the longest RGI emoji sequences
+		static constexpr size_t MAX_TEXT_LEN = 39;
+
+		// the UTF-8 of the cluster, which is not terminated
+		char text[MAX_TEXT_LEN] = { ' ' };
+		uint8_t text_len = 1;
+
+		// A wide cluster is stored in the first of its two cells, and the
+		// second one is empty with a width of 0.
+		uint8_t width = 1;
+
+		uint16_t attrs = 0;
+		twig::color::Color fg;
+		twig::color::Color bg;
+
+		bool is_continuation() const {
+			return width == 0;
+		}
+
+		bool has_same_style(const Cell& o) const {
+			return attrs == o.attrs && fg == o.fg && bg == o.bg;
+		}
+
+		bool operator==(const Cell& o) const {
+			return text_len == o.text_len
+				&& width == o.width
+				&& has_same_style(o)
+				&& std::memcmp(text, o.text, text_len) == 0;
+		}
+
+		bool operator!=(const Cell& o) const {
+			return !operator==(o);
+		}
+	};
+
+	class CellGrid {
+		public:
+			const WDim& get_size() const { return size; }
+
+			// everything is blank afterwards
+			void resize(const WDim& new_size);
+
+			Cell& at(WInt x, WInt y) {
+				return cells[(size_t) y * size.width + x];
+			}
+
+			const Cell& at(WInt x, WInt y) const {
+				return cells[(size_t) y * size.width + x];
+			}
+
+			// Blanks the cells in r. Wide clusters that r cuts in half are
+			// blanked entirely, so no half of one is left behind.
+			void clear_rect(const WRect& r);
+
+		private:
+			WDim size { 0, 0 };
+			std::vector<Cell> cells;
+	};
+
+	// Graphics that paint into a cell grid instead of an ncurses pad. Text
+	// is clipped at the right edge rather than wrapped.
+	class GridGraphics : public twig::widget::Graphics {
+		public:
+			GridGraphics() {}
+			~GridGraphics() override {}
+
+			const CellGrid& get_grid() const { return grid; }
+
+			WDim get_size(void) override { return grid.get_size(); }
+			WPoint get_position(void) override { return cursor; }
+
+			void clear_fast(void) override;
+			void clear_full(void) override;
+			void clear_rect(const WRect& r) override;
+
+			void set_normal(void) override;
+
+			void set_color_pair(const twig::color::ColorPair &c) override;
+
+			void set_standout  (const bool b) override { set_attr(Attr::STANDOUT, b); }
+			void set_underline (const bool b) override { set_attr(Attr::UNDERLINE, b); }
+			void set_reverse   (const bool b) override { set_attr(Attr::REVERSE, b); }
+			void set_blink     (const bool b) override { set_attr(Attr::BLINK, b); }
+			void set_dim       (const bool b) override { set_attr(Attr::DIM, b); }
+			void set_bold      (const bool b) override { set_attr(Attr::BOLD, b); }
+			void set_protect   (const bool b) override {}
+			void set_invisible (const bool b) override { set_attr(Attr::INVISIBLE, b); }
+			void set_italic    (const bool b) override { set_attr(Attr::ITALIC, b); }
+
+			void mv(WInt x, WInt y) override { cursor = { x, y }; }
+
+			void add_ch(char c) override;
+
+			// the string is UTF-8, see Graphics::add_str_utf8
+			void add_str_raw(const char* str, const size_t len) override;
+
+			void add_str_raw(const char* str) override {
+				add_str_raw(str, std::strlen(str));
+			}
+
+			// the clusters are already measured, so they are just copied
+			void add_render_text(const twig::text::RenderText& text) override;
+
+			void when_owner_resized(const WDim& new_size) override;
+
+		private:
+			CellGrid grid;
+			WPoint cursor { 0, 0 };
+
+			// the style of what is painted next
+			Cell pen;
+
+			// reused by add_str_raw, so painting does not allocate
+			Unicode::string_t decoded;
+
+			void set_attr(uint16_t attr, bool b) {
+				if (b) pen.attrs |= attr;
+				else   pen.attrs &= ~attr;
+			}
+
+			// puts a cluster at the cursor, and moves the cursor past it
+			void put(const char* text, size_t text_len, uint8_t width);
+	};
+
+	// What the terminal shows, and the escape sequences to change that
+	class Screen {
+		public:
+			Screen(int fd) : fd(fd) {}
+
+			// Makes the terminal show back, which must cover all of it, with
+			// a single write. Only the cells that changed since the last
+			// time are sent, inside a synchronized update so the terminal
+			// never shows half of a frame.
+			void present(const CellGrid& back);
+
+			// Forgets what is on the screen, so all of it is sent next time,
+			// e.g. after another program had the terminal.
+			void invalidate() {
+				front_valid = false;
+			}
+
+			bool is_valid() const {
+				return front_valid;
+			}
+
+		private:
+			const int fd;
+
+			CellGrid front;
+			bool front_valid = false;
+
+			// the output of a frame, kept to reuse its memory
+			std::string out;
+
+			// where the terminal cursor is, if known
+			bool cursor_valid = false;
+			WInt cursor_x = 0;
+			WInt cursor_y = 0;
+
+			// the style the terminal is drawing in, if known
+			bool pen_valid = false;
+			Cell pen;
+
+			// the most cells that are sent again, rather than moved over
+			static constexpr WInt MAX_RESENT_CELLS = 4;
+
+			// whether the cells from first up to end can be sent as they
+			// are, in the style the terminal is drawing in
+			bool can_resend(const CellGrid& back, WInt first, WInt end, WInt y) const;
+
+			void move_to(WInt x, WInt y);
+			void set_style(const Cell& style);
+			void write_out();
+	};
+
+}
+
+#endif
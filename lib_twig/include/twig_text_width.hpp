@@ -0,0 +1,77 @@
+#ifndef INCLUDED_TWIG_TEXT_WIDTH_HPP
+#define INCLUDED_TWIG_TEXT_WIDTH_HPP
+
+#include "unicode.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <cstdint>
+
+namespace twig::text {
+
+	// A string as it is painted: its UTF-8, and where each grapheme cluster
+	// of it starts and how many columns it takes up.
+	struct RenderText {
+		struct Grapheme {
+			uint32_t offset;
+			uint16_t len;
+			uint8_t width;
+		};
+
+		std::string utf8;
+		std::vector<Grapheme> graphemes;
+		size_t width = 0;
+
+		RenderText() {}
+		RenderText(const Unicode::string_t& s, Unicode::AmbiguousWidth ambiguous);
+	};
+
+	// Remembers the RenderText of strings by a version number, which has to
+	// be different for every different string, so that painting what was
+	// painted before neither encodes nor measures it again. Finding one
+	// does not even hash the string.
+	class RenderTextCache {
+		public:
+			RenderTextCache(size_t capacity = 1024) : capacity(capacity) {}
+
+			// the reference is good until the next call
+			const RenderText& get(uint64_t version, const Unicode::string_t& s) {
+				auto it = texts.find(version);
+				if (it != texts.end()) {
+					return it->second;
+				}
+
+				// there is no eviction order, we just start over
+				if (texts.size() >= capacity) {
+					texts.clear();
+				}
+
+				return texts.emplace(version, RenderText(s, ambiguous)).first->second;
+			}
+
+			Unicode::AmbiguousWidth get_ambiguous_width() const {
+				return ambiguous;
+			}
+
+			void set_ambiguous_width(Unicode::AmbiguousWidth x) {
+				if (x != ambiguous) {
+					ambiguous = x;
+					texts.clear();
+				}
+			}
+
+			void clear() {
+				texts.clear();
+			}
+
+		private:
+			const size_t capacity;
+			Unicode::AmbiguousWidth ambiguous = Unicode::AmbiguousWidth::Narrow;
+			std::unordered_map<uint64_t, RenderText> texts;
+	};
+
+}
+
+#endif
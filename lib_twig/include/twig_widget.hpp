@@ -4,6 +4,7 @@
 #include "twig_constants.hpp"
 #include "twig_geometry.hpp"
 #include "twig_color.hpp"
+#include "twig_text_width.hpp"
 
 #include "unicode.hpp"
 #include "encoding.hpp"
@@ -12,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <optional>
+#include <vector>
 
 #include <cassert>
 
@@ -29,34 +31,40 @@ namespace twig::widget {
 
 			Graphics() : Graphics(nullptr) {}
 			Graphics(void* magic) : magic(magic) {}
-			~Graphics();
 
-			WDim get_size(void);
-			WPoint get_position(void);
+			// By default this paints into an ncurses pad, which magic
+			// points to. Other backends override everything below.
+			virtual ~Graphics();
 
-			void clear_fast(void);
-			void clear_full(void);
+			virtual WDim get_size(void);
+			virtual WPoint get_position(void);
 
-			void set_normal(void);
+			virtual void clear_fast(void);
+			virtual void clear_full(void);
 
-			void set_color_pair(const twig::color::ColorPair &c);
+			// blanks part of the window, without touching the rest
+			virtual void clear_rect(const WRect& r);
 
-			void set_standout  (const bool b);
-			void set_underline (const bool b);
-			void set_reverse   (const bool b);
-			void set_blink     (const bool b);
-			void set_dim       (const bool b);
-			void set_bold      (const bool b);
-			void set_protect   (const bool b);
-			void set_invisible (const bool b);
-			void set_italic    (const bool b);
+			virtual void set_normal(void);
 
-			void mv(WInt x, WInt y);
+			virtual void set_color_pair(const twig::color::ColorPair &c);
 
-			void add_ch(char c);
+			virtual void set_standout  (const bool b);
+			virtual void set_underline (const bool b);
+			virtual void set_reverse   (const bool b);
+			virtual void set_blink     (const bool b);
+			virtual void set_dim       (const bool b);
+			virtual void set_bold      (const bool b);
+			virtual void set_protect   (const bool b);
+			virtual void set_invisible (const bool b);
+			virtual void set_italic    (const bool b);
 
-			void add_str_raw(const char* str, const size_t len);
-			void add_str_raw(const char* str);
+			virtual void mv(WInt x, WInt y);
+
+			virtual void add_ch(char c);
+
+			virtual void add_str_raw(const char* str, const size_t len);
+			virtual void add_str_raw(const char* str);
 
 			inline void add_str_raw(const std::string& str) {
 				add_str_raw(str.c_str(), str.size());
@@ -129,32 +137,47 @@ namespace twig::widget {
 				add_str_utf8(str);
 			}
 
-			void when_owner_resized(const WDim& new_size);
+			virtual void when_owner_resized(const WDim& new_size);
 
+			// terminal columns, counted per grapheme cluster
 			inline unsigned short get_str_width(Unicode::codepoint_t cp) {
-				using X = Unicode::EastAsianWidth;
-				const auto width_prop = Unicode::get_east_asian_width(cp);
-				switch(width_prop) {
-					case X::F:
-					case X::W:
-						return 2;
-					default:
-						return 1;
-				}
+				return Unicode::get_display_width(cp, get_ambiguous_width());
 			}
 
-			template <typename T>
-			inline unsigned short get_str_width(T s, size_t start, size_t end) {
-				unsigned short sum = 0;
-				for (size_t i = start; i < end; i++) {
-					sum += get_str_width(s[i]);
-				}
-				return sum;
+			inline unsigned short get_str_width(const Unicode::string_t& s, size_t start, size_t end) {
+				assert(start <= end && end <= s.size());
+				return Unicode::get_display_width(
+						s.data() + start,
+						end - start,
+						get_ambiguous_width());
+			}
+
+			inline unsigned short get_str_width(const Unicode::string_t& s) {
+				return Unicode::get_display_width(s, get_ambiguous_width());
+			}
+
+			// Encoded and measured once per version of a string, see
+			// twig::text::RenderTextCache. Painting it then only copies bytes.
+			inline const twig::text::RenderText& get_render_text(
+					uint64_t version,
+					const Unicode::string_t& s) {
+				return render_text_cache.get(version, s);
+			}
+
+			virtual void add_render_text(const twig::text::RenderText& text) {
+				add_str_utf8(text.utf8);
 			}
 
-			inline unsigned short get_str_width(Unicode::string_t s) {
-				return get_str_width(s, 0, s.size());
+			void set_ambiguous_width(Unicode::AmbiguousWidth x) {
+				render_text_cache.set_ambiguous_width(x);
 			}
+
+			Unicode::AmbiguousWidth get_ambiguous_width() const {
+				return render_text_cache.get_ambiguous_width();
+			}
+
+		private:
+			twig::text::RenderTextCache render_text_cache;
 	};
 
 	inline std::unique_ptr<Graphics> request_graphics() {
@@ -173,8 +196,67 @@ namespace twig::widget {
 
 			virtual ~Widget() {}
 
+			// Paints the parts of the widget that were invalidated, see
+			// is_invalidated. The rest is left as it was painted before.
 			virtual void repaint() = 0;
 
+			// Marks a region as needing to be repainted, which is clipped
+			// to the widget. Regions that touch are merged, and so are all
+			// of them once there are too many to be worth keeping apart.
+			void invalidate(const WRect& region) {
+				const WRect clipped = region.intersection({ size.width, size.height });
+				if (clipped.is_zero()) return;
+
+				for (WRect& dirty : dirty_regions) {
+					if (dirty.contains(clipped)) return;
+					if (dirty.touches(clipped)) {
+						dirty = dirty.bounding_union(clipped);
+						return;
+					}
+				}
+
+				if (dirty_regions.size() < MAX_DIRTY_REGIONS) {
+					dirty_regions.push_back(clipped);
+					return;
+				}
+
+				WRect all = clipped;
+				for (const WRect& dirty : dirty_regions) {
+					all = all.bounding_union(dirty);
+				}
+				dirty_regions.assign(1, all);
+			}
+
+			// the whole widget
+			void invalidate() {
+				invalidate({ size.width, size.height });
+			}
+
+			bool needs_repaint() const {
+				return !dirty_regions.empty();
+			}
+
+			// whether any of region needs to be repainted
+			bool is_invalidated(const WRect& region) const {
+				for (const WRect& dirty : dirty_regions) {
+					if (dirty.intersects(region)) return true;
+				}
+				return false;
+			}
+
+			bool is_fully_invalidated() const {
+				const WRect all { size.width, size.height };
+				for (const WRect& dirty : dirty_regions) {
+					if (dirty.contains(all)) return true;
+				}
+				return false;
+			}
+
+			// called once the widget has been repainted
+			void clear_invalidation() {
+				dirty_regions.clear();
+			}
+
 			bool is_graphical() const noexcept {
 				return true;
 			}
@@ -184,6 +266,17 @@ namespace twig::widget {
 				return graphics;
 			}
 
+			// Swaps in the graphics of another backend. Everything is
+			// painted again, since the new ones start out blank.
+			void set_graphics(std::unique_ptr<Graphics> new_graphics) {
+				assert(is_graphical() && new_graphics != nullptr);
+				graphics = std::move(new_graphics);
+				if (size.width > 0 && size.height > 0) {
+					graphics->when_owner_resized(size);
+				}
+				invalidate();
+			}
+
 			WPoint& get_position(void) { return position; }
 
 			WDim& get_size(void) { return size; }
@@ -199,13 +292,22 @@ namespace twig::widget {
 					if (is_graphical()) {
 						graphics->when_owner_resized(new_size);
 					}
+					invalidate();
+					when_resized(new_size);
 				}
 			}
 
+		protected:
+			virtual void when_resized(const WDim& new_size) {}
+
 		private:
+			static constexpr size_t MAX_DIRTY_REGIONS = 8;
+
 			WPoint position {0, 0};
 			WDim size {0, 0};
 			std::unique_ptr<Graphics> graphics = nullptr;
+
+			std::vector<WRect> dirty_regions;
 	};
 }
 
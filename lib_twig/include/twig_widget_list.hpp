@@ -3,12 +3,22 @@
 
 #include "twig_widget.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+
 #include <cassert>
 
 namespace twig::widget {
 
 	template<typename T> class ListModel {
 		public:
+			// called with the rows from first up to end that changed
+			typedef std::function<void(size_t first, size_t end)> InvalidationListener;
+
+			// called with the index of an element, and the element
+			typedef std::function<void(size_t idx, const T& element)> Visitor;
+
 			ListModel() {}
 			virtual ~ListModel() {}
 
@@ -18,12 +28,22 @@ namespace twig::widget {
 
 			void set_selection_index(size_t idx) {
 				assert(idx < num_elements());
-				selection_index = idx;
+				select(idx);
 			}
 
 			virtual size_t num_elements() = 0;
 			virtual T get_element(size_t idx) = 0;
 
+			// Calls visit with each element from first up to end, without
+			// copying them. By default this goes through get_element, which
+			// models that store their elements should avoid by overriding it.
+			virtual void visit_range(size_t first, size_t end, const Visitor& visit) {
+				for (size_t idx = first; idx < end; idx++) {
+					const T element = get_element(idx);
+					visit(idx, element);
+				}
+			}
+
 			bool is_empty() {
 				return num_elements() == 0;
 			}
@@ -33,7 +53,7 @@ namespace twig::widget {
 				if (num_elems == 0) return;
 
 				if (selection_index >= magnitude) {
-					selection_index -= magnitude;
+					select(selection_index - magnitude);
 				}
 			}
 
@@ -42,15 +62,108 @@ namespace twig::widget {
 				if (num_elems == 0) return;
 
 				if (selection_index < num_elems - magnitude) {
-					selection_index += magnitude;
+					select(selection_index + magnitude);
+				}
+			}
+
+			// The selection and the page move together, so the selected
+			// row stays where it is on the screen, unless the list ends.
+			void page_down() {
+				const size_t num_elems = num_elements();
+				if (num_elems == 0) return;
+
+				const size_t step = std::max<size_t>(page_size, 1);
+				set_scroll_offset(std::min(scroll_offset + step, max_scroll_offset()));
+				select(std::min(selection_index + step, num_elems - 1));
+			}
+
+			void page_up() {
+				if (is_empty()) return;
+
+				const size_t step = std::max<size_t>(page_size, 1);
+				set_scroll_offset(scroll_offset - std::min(scroll_offset, step));
+				select(selection_index - std::min(selection_index, step));
+			}
+
+			void home() { select(0); }
+
+			void end() {
+				if (is_empty()) return;
+				select(num_elements() - 1);
+			}
+
+			// the first row that is on the screen
+			size_t get_scroll_offset() {
+				return scroll_offset;
+			}
+
+			// the number of rows that fit on the screen, set by the view
+			void set_page_size(size_t rows) {
+				page_size = rows;
+				scroll_to_selection();
+			}
+
+			// Scrolls as little as possible to bring the selection onto the
+			// screen, without leaving rows empty at the bottom that could
+			// show elements. Moving the selection does this by itself, but
+			// removing elements does not.
+			void scroll_to_selection() {
+				if (page_size == 0) return;
+
+				size_t offset = std::min(scroll_offset, max_scroll_offset());
+				if (selection_index < offset) {
+					offset = selection_index;
+				} else if (selection_index >= offset + page_size) {
+					offset = selection_index - page_size + 1;
 				}
+				set_scroll_offset(offset);
 			}
 
-			void home() { selection_index = 0; }
-			void end() { selection_index = num_elements() - 1; }
+			// Tells the view that the rows from first up to end need to be
+			// repainted, e.g. because their elements changed, or moved
+			// after an insertion. Moving the selection does this by itself.
+			void invalidate_rows(size_t first, size_t end) {
+				if (listener && first < end) listener(first, end);
+			}
+
+			void invalidate_all() {
+				invalidate_rows(0, std::numeric_limits<size_t>::max());
+			}
+
+			void set_invalidation_listener(InvalidationListener new_listener) {
+				listener = new_listener;
+			}
 
 		protected:
 			size_t selection_index = 0;
+
+		private:
+			InvalidationListener listener;
+
+			size_t scroll_offset = 0;
+			size_t page_size = 0;
+
+			size_t max_scroll_offset() {
+				const size_t num_elems = num_elements();
+				return num_elems > page_size ? num_elems - page_size : 0;
+			}
+
+			// every row on the screen changes when the list scrolls
+			void set_scroll_offset(size_t offset) {
+				if (offset == scroll_offset) return;
+				scroll_offset = offset;
+				invalidate_all();
+			}
+
+			// only the rows that were and are selected change, unless the
+			// list has to scroll to follow
+			void select(size_t idx) {
+				if (idx == selection_index) return;
+				invalidate_rows(selection_index, selection_index + 1);
+				selection_index = idx;
+				invalidate_rows(idx, idx + 1);
+				scroll_to_selection();
+			}
 	};
 
 	template<typename T> class ListController {
@@ -93,8 +206,10 @@ namespace twig::widget {
 						model->end();
 						break;
 					case X::NPAGE:
+						model->page_down();
 						break;
 					case X::PPAGE:
+						model->page_up();
 						break;
 					default:
 						break;
@@ -107,47 +222,98 @@ namespace twig::widget {
 
 	template<typename T> class ListPainter : public Widget {
 		public:
-			ListPainter(ListModel<T> *model) : model(model) {}
-			virtual ~ListPainter() {}
+			ListPainter(ListModel<T> *model) : model(model) {
+				model->set_invalidation_listener([this](size_t first, size_t end) {
+					invalidate_rows(first, end);
+				});
+			}
 
+			virtual ~ListPainter() {
+				model->set_invalidation_listener(nullptr);
+			}
+
+			// the rows of the model from first up to end, where they are on
+			// the screen, if they are
+			void invalidate_rows(size_t first, size_t end) {
+				const size_t offset = model->get_scroll_offset();
+				if (end <= offset) return;
+				first = first > offset ? first - offset : 0;
+				end -= offset;
+
+				const WDim& size = get_size();
+				const size_t visible = size.height / row_height;
+				if (first >= visible) return;
+				end = std::min(end, visible);
+
+				invalidate({
+					0,
+					(WInt) (first * row_height),
+					size.width,
+					(WInt) ((end - first) * row_height)
+				});
+			}
+
+			// Only the rows on the screen are visited, so this costs the
+			// same however long the list is. The elements are painted by
+			// reference, so nothing is copied either.
 			void repaint() override {
 				auto& g = get_graphics();
 				const WDim bounds = g->get_size();
 
-				g->clear_fast();
-
-				// for now we assume that every row has a height of 1
-				const unsigned short row_height = 1;
-
-				const size_t max_row = model->num_elements();
-
-				unsigned short draw_y = 0;
-				size_t row = 0;
-				WRect row_bounds;
+				// either everything is cleared at once, or just the rows
+				// that changed, one by one
+				if (is_fully_invalidated()) {
+					g->clear_fast();
+				} else {
+					for (WInt draw_y = 0; draw_y < bounds.height; draw_y += row_height) {
+						const WRect row_bounds { 0, draw_y, bounds.width, row_height };
+						if (is_invalidated(row_bounds)) g->clear_rect(row_bounds);
+					}
+				}
 
-				for (;
-						draw_y < bounds.height && row < max_row;
-						row++, draw_y += row_height) {
+				const size_t first = model->get_scroll_offset();
+				const size_t end = std::min(
+						model->num_elements(),
+						first + bounds.height / row_height);
 
-					row_bounds = {
-						0,
-						draw_y,
-						bounds.width,
-						row_height
-					};
+				// capturing only this keeps the visitor small enough for
+				// std::function to store without allocating
+				model->visit_range(first, end, [this](size_t row, const T& value) {
+					const WRect row_bounds = get_row_bounds(row);
+					if (!is_invalidated(row_bounds)) return;
 
 					draw_row(
-							g,
+							get_graphics(),
 							row_bounds,
-							model->get_element(row),
+							value,
 							row,
 							row == model->get_selection_index());
-				}
+				});
 			}
 
 		protected:
+			// for now we assume that every row has a height of 1
+			static constexpr unsigned short row_height = 1;
+
 			ListModel<T>* const model;
 
+			// where a row of the model is on the screen, which it must be
+			WRect get_row_bounds(size_t row) {
+				const size_t offset = model->get_scroll_offset();
+				assert(row >= offset);
+
+				return {
+					0,
+					(WInt) ((row - offset) * row_height),
+					get_size().width,
+					row_height
+				};
+			}
+
+			void when_resized(const WDim& new_size) override {
+				model->set_page_size(new_size.height / row_height);
+			}
+
 			virtual void draw_row(
 					std::unique_ptr<Graphics>& g,
 					const WRect& bounds,
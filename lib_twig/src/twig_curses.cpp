@@ -1,18 +1,34 @@
 #include "twig_app.hpp"
+#include "twig_frame_scheduler.hpp"
 
 #include <stdexcept>
 #include <iostream>
 #include <memory>
 
 #include <cerrno>
+#include <csignal>
 #include <cstring>
 #include <cassert>
 
 #include <ncurses.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
 bool in_app_mode = false;
 WINDOW* stdscr;
 
+namespace {
+
+	// pastes come as one event, see twig::TwigApp::when_pasted
+	void set_bracketed_paste(bool enabled) {
+		const char* const sequence = enabled ? "\x1B[?2004h" : "\x1B[?2004l";
+		if (write(STDOUT_FILENO, sequence, std::strlen(sequence)) == -1) {
+			// the terminal just will not mark pastes
+		}
+	}
+
+}
+
 void twig::curses::init() {
 	if (in_app_mode) return;
 
@@ -26,6 +42,9 @@ void twig::curses::init() {
 	// this prevents the screen from being blank at launch
 	wrefresh(stdscr);
 
+	// curses does not know about bracketed paste, so it is sent as it is
+	set_bracketed_paste(true);
+
 	in_app_mode = true;
 }
 
@@ -37,6 +56,7 @@ void twig::curses::exit() {
 	echo();
 	curs_set(1);
 
+	set_bracketed_paste(false);
 	endwin();
 
 	in_app_mode = false;
@@ -47,6 +67,7 @@ using twig::widget::Graphics;
 using twig::widget::WInt;
 using twig::widget::WDim;
 using twig::widget::WPoint;
+using twig::widget::WRect;
 
 using twig::color::ColorPair;
 
@@ -88,6 +109,24 @@ void Graphics::clear_full(void) {
 	wclear((WINDOW*) magic);
 }
 
+void Graphics::clear_rect(const WRect& r) {
+	assert(magic != nullptr);
+	WINDOW* w = (WINDOW*) magic;
+
+	const WDim size = get_size();
+	const WRect clipped = r.intersection({ size.width, size.height });
+	const bool to_eol = clipped.x + clipped.width == size.width;
+
+	for (WInt y = clipped.y; y < clipped.y + clipped.height; y++) {
+		if (to_eol) {
+			wmove(w, y, clipped.x);
+			wclrtoeol(w);
+		} else {
+			mvwhline(w, y, clipped.x, ' ', clipped.width);
+		}
+	}
+}
+
 void Graphics::set_color_pair(const ColorPair &c) {
 	// TODO this will get interesting :)
 }
@@ -171,27 +210,6 @@ void Graphics::set_italic(const bool b) {
 	else   wattroff((WINDOW*) magic, A_ITALIC);  
 }
 
-// FIXME here we assume the terminal is in UTF-8
-auto decoder = encoding::get_decoder(encoding::Encoding::UTF8);
-
-twig::special_key get_special_key(int curses_key) {
-	using X = twig::special_key;
-
-	switch (curses_key) {
-		case KEY_UP:        return X::UP;
-		case KEY_DOWN:      return X::DOWN;
-		case KEY_LEFT:      return X::LEFT;
-		case KEY_RIGHT:     return X::RIGHT;
-		case KEY_HOME:      return X::HOME;
-		case KEY_END:       return X::END;
-		case KEY_ENTER:     return X::ENTER;
-		case KEY_NPAGE:     return X::NPAGE;
-		case KEY_PPAGE:     return X::PPAGE;
-		case KEY_BACKSPACE: return X::BACKSPACE;
-		default: return X::OTHER;
-	}
-}
-
 inline void do_repaint(twig::TwigApp *app) {
 	assert(app != nullptr);
 
@@ -199,7 +217,11 @@ inline void do_repaint(twig::TwigApp *app) {
 
 	assert(root_widget != nullptr);
 
+	// nothing changed since the last repaint
+	if (!root_widget->needs_repaint()) return;
+
 	root_widget->repaint();
+	root_widget->clear_invalidation();
 
 	WDim root_dim = root_widget->get_size();
 	WPoint root_ul = root_widget->get_position();
@@ -216,13 +238,20 @@ inline void do_repaint(twig::TwigApp *app) {
 			root_ul.y + root_dim.height,
 			root_ul.x + root_dim.width);
 
-	wrefresh(stdscr);
+	doupdate();
 
 }
 
 inline void do_resize(twig::TwigApp *app) {
 	assert(app != nullptr);
 
+	// ncurses only finds out about the new size through getch, which is
+	// not used, so it is told
+	struct winsize ws;
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+		resizeterm(ws.ws_row, ws.ws_col);
+	}
+
 	// this prevents strange behavior while resizing
 	wrefresh(stdscr);
 
@@ -235,6 +264,20 @@ inline void do_resize(twig::TwigApp *app) {
 	root_widget->set_size({maxx, maxy});
 }
 
+namespace {
+
+	// resizes wait for the next frame, so that a flood of them is one resize
+	volatile sig_atomic_t resize_pending = 0;
+
+	twig::EventLoop* active_loop = nullptr;
+
+	void when_resized(int) {
+		resize_pending = 1;
+		if (active_loop != nullptr) active_loop->wake();
+	}
+
+}
+
 int twig::curses::run_twig_app(TwigApp *app) {
 
 	if (app == nullptr) {
@@ -254,33 +297,56 @@ int twig::curses::run_twig_app(TwigApp *app) {
 		do_resize(app);
 		do_repaint(app);
 
-		int ch;
+		// Replaces the handler of ncurses, which only reports resizes
+		// through getch. Without SA_RESTART, a resize interrupts the wait.
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_handler = when_resized;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGWINCH, &action, nullptr);
 
-		while (app->is_running()) {
+		twig::EventLoop& events = app->get_event_loop();
+		active_loop = &events;
 
-			ch = getch();
+		bool terminal_gone = false;
+		twig::input::InputReader input(STDIN_FILENO, app, events);
+		input.set_escape_timeout(std::chrono::milliseconds(app->get_escape_timeout()));
+		input.set_paste_timeout(std::chrono::milliseconds(app->get_paste_timeout()));
+		events.watch(STDIN_FILENO, [&input, &terminal_gone]() {
+			terminal_gone = !input.read_available();
+		});
 
-			if (ch == -1) {
+		twig::FrameScheduler frames(app->get_max_fps());
+		frames.painted();
+
+		Widget* root_widget = app->get_root_widget();
+
+		// everything that happened is handled before one repaint
+		while (app->is_running() && !terminal_gone) {
+
+			const bool pending = resize_pending || root_widget->needs_repaint();
+			const int timeout = frames.get_wait_timeout(pending, app->get_idle_timeout());
+
+			if (!events.run_once(timeout) && !pending) {
 				app->when_no_event();
+			}
 
-			} else if (ch >= 0 && ch <= 0xFF) {
-				char ch_real = (char) ch;
-				Unicode::string_t s = decoder->decode(&ch_real, 1);
-				for(auto cp : s) {
-					app->when_typed(cp);
-				}
+			if (!frames.is_due()) continue;
+			if (!resize_pending && !root_widget->needs_repaint()) continue;
 
-			} else if (ch == KEY_RESIZE) {
+			if (resize_pending) {
+				resize_pending = 0;
 				do_resize(app);
-
-			} else {
-				app->when_typed_special(get_special_key(ch));
 			}
 
 			do_repaint(app);
+			frames.painted();
 
 		}
 
+		events.unwatch(STDIN_FILENO);
+		active_loop = nullptr;
+
 		twig::curses::exit();
 
 		app->when_exiting();
@@ -288,6 +354,9 @@ int twig::curses::run_twig_app(TwigApp *app) {
 		return 0;
 
 	} catch (const std::exception& e) {
+		app->get_event_loop().unwatch(STDIN_FILENO);
+		active_loop = nullptr;
+
 		twig::curses::exit();
 
 		std::cerr << "Uncaught exception: " << e.what() << std::endl;
@@ -0,0 +1,182 @@
+#include "twig_event_loop.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+#include <cerrno>
+#include <cstdint>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+using twig::EventLoop;
+
+// how many events one call of epoll_wait can return
+constexpr int MAX_EVENTS = 16;
+
+inline struct timespec to_timespec(std::chrono::milliseconds ms) {
+	struct timespec ret;
+	ret.tv_sec = ms.count() / 1000;
+	ret.tv_nsec = (ms.count() % 1000) * 1000000;
+	return ret;
+}
+
+EventLoop::EventLoop() {
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd == -1) {
+		throw std::runtime_error("epoll_create1");
+	}
+
+	wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (wake_fd == -1) {
+		close(epoll_fd);
+		throw std::runtime_error("eventfd");
+	}
+
+	struct epoll_event event {};
+	event.events = EPOLLIN;
+	event.data.fd = wake_fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) == -1) {
+		close(wake_fd);
+		close(epoll_fd);
+		throw std::runtime_error("epoll_ctl");
+	}
+}
+
+EventLoop::~EventLoop() {
+	for (const auto& timer : timer_repeats) {
+		close(timer.first);
+	}
+	close(wake_fd);
+	close(epoll_fd);
+}
+
+void EventLoop::watch(int fd, Callback when_ready) {
+	struct epoll_event event {};
+	event.events = EPOLLIN;
+	event.data.fd = fd;
+
+	const int op = watched.count(fd) > 0 ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	if (epoll_ctl(epoll_fd, op, fd, &event) == -1) {
+		throw std::runtime_error("epoll_ctl");
+	}
+
+	watched[fd] = when_ready;
+}
+
+void EventLoop::unwatch(int fd) {
+	if (watched.erase(fd) == 0) return;
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+EventLoop::TimerId EventLoop::add_timer(
+		std::chrono::milliseconds delay,
+		std::chrono::milliseconds interval,
+		Callback fn) {
+
+	const int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+	if (timer_fd == -1) {
+		throw std::runtime_error("timerfd_create");
+	}
+
+	// a zero delay would disarm it
+	struct itimerspec spec {};
+	spec.it_value = to_timespec(std::max(delay, std::chrono::milliseconds(1)));
+	spec.it_interval = to_timespec(interval);
+
+	if (timerfd_settime(timer_fd, 0, &spec, nullptr) == -1) {
+		close(timer_fd);
+		throw std::runtime_error("timerfd_settime");
+	}
+
+	const TimerId id = timer_fd;
+	timer_repeats[id] = interval.count() > 0;
+
+	watch(timer_fd, [this, id, fn]() {
+		// the number of expirations, which is not needed
+		uint64_t expirations;
+		if (read(id, &expirations, sizeof(expirations)) == -1) return;
+
+		const bool repeats = timer_repeats[id];
+		fn();
+		if (!repeats) remove_timer(id);
+	});
+
+	return id;
+}
+
+void EventLoop::remove_timer(TimerId id) {
+	if (timer_repeats.erase(id) == 0) return;
+	unwatch(id);
+	close(id);
+}
+
+void EventLoop::post(Callback fn) {
+	{
+		std::lock_guard<std::mutex> lock(posted_mutex);
+		posted.push_back(fn);
+	}
+	wake();
+}
+
+void EventLoop::wake() {
+	// only async-signal-safe calls in here
+	const uint64_t one = 1;
+	const int saved_errno = errno;
+	if (write(wake_fd, &one, sizeof(one)) == -1) {
+		// the counter is full, so a wakeup is pending anyway
+	}
+	errno = saved_errno;
+}
+
+void EventLoop::run_posted() {
+	{
+		std::lock_guard<std::mutex> lock(posted_mutex);
+		running.swap(posted);
+	}
+
+	for (const Callback& fn : running) {
+		fn();
+	}
+	running.clear();
+}
+
+bool EventLoop::run_once(int timeout_ms) {
+	struct epoll_event events[MAX_EVENTS];
+
+	const int n = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms);
+
+	if (n == -1) {
+		// a signal, such as a resize, counts as something happening
+		if (errno == EINTR) {
+			errno = 0;
+			return true;
+		}
+		throw std::runtime_error("epoll_wait");
+	}
+
+	for (int i = 0; i < n; i++) {
+		const int fd = events[i].data.fd;
+
+		if (fd == wake_fd) {
+			uint64_t count;
+			if (read(wake_fd, &count, sizeof(count)) == -1) {
+				// someone else already reset it
+			}
+			run_posted();
+			continue;
+		}
+
+		// An earlier callback may have removed this one. The callback is
+		// copied, since it may also remove itself.
+		auto it = watched.find(fd);
+		if (it == watched.end()) continue;
+
+		const Callback callback = it->second;
+		callback();
+	}
+
+	return n > 0;
+}
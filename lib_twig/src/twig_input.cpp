@@ -0,0 +1,267 @@
+#include "twig_input.hpp"
+#include "twig_app.hpp"
+
+#include <stdexcept>
+
+#include <cerrno>
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+using twig::special_key;
+using twig::input::KeyEvent;
+using twig::input::InputParser;
+using twig::input::InputReader;
+
+namespace {
+
+	constexpr char ESC = 0x1B;
+
+	inline special_key get_function_key(unsigned int n) {
+		return (special_key) ((uint8_t) special_key::F1 + n - 1);
+	}
+
+	inline special_key get_ss3_key(char final) {
+		using X = special_key;
+
+		switch (final) {
+			case 'A': return X::UP;
+			case 'B': return X::DOWN;
+			case 'C': return X::RIGHT;
+			case 'D': return X::LEFT;
+			case 'H': return X::HOME;
+			case 'F': return X::END;
+			case 'M': return X::ENTER;
+			case 'P': case 'Q': case 'R': case 'S':
+				return get_function_key(final - 'P' + 1);
+			default: return X::OTHER;
+		}
+	}
+
+	// the key of a whole CSI sequence, ESC [ params final
+	special_key get_csi_key(const std::string& s) {
+		using X = special_key;
+
+		// only the first parameter matters, the rest are modifiers
+		unsigned int param = 0;
+		for (size_t i = 2; i < s.size() && s[i] >= '0' && s[i] <= '9'; i++) {
+			param = param * 10 + (s[i] - '0');
+		}
+
+		switch (s.back()) {
+			case 'A': return X::UP;
+			case 'B': return X::DOWN;
+			case 'C': return X::RIGHT;
+			case 'D': return X::LEFT;
+			case 'H': return X::HOME;
+			case 'F': return X::END;
+			case '~':
+				switch (param) {
+					case 1: case 7: return X::HOME;
+					case 4: case 8: return X::END;
+					case 3:         return X::DELETE;
+					case 5:         return X::PPAGE;
+					case 6:         return X::NPAGE;
+					case 11: case 12: case 13: case 14: case 15:
+						return get_function_key(param - 10);
+					case 17: case 18: case 19: case 20: case 21:
+						return get_function_key(param - 11);
+					case 23: case 24:
+						return get_function_key(param - 12);
+					default: return X::OTHER;
+				}
+			default: return X::OTHER;
+		}
+	}
+
+}
+
+/***** InputParser *****/
+
+// what the terminal sends around a paste, in bracketed paste mode
+const std::string PASTE_START = "\x1b[200~";
+const Unicode::string_t PASTE_END = U"\x1b[201~";
+
+void InputParser::feed(const char* bytes, size_t len, std::vector<KeyEvent>& out) {
+	for (size_t i = 0; i < len; i++) {
+		if (in_paste) {
+			feed_paste(bytes[i], out);
+		} else if (!escape.empty()) {
+			feed_escape(bytes[i], out);
+		} else {
+			feed_byte(bytes[i], out);
+		}
+	}
+}
+
+void InputParser::feed_paste(unsigned char b, std::vector<KeyEvent>& out) {
+	paste_decoder.feed(b, [this](Unicode::codepoint_t codepoint) {
+		paste.push_back(codepoint);
+	});
+
+	// the end of it is all ASCII, and ends with ~
+	if (b != '~' || paste.size() < PASTE_END.size()) return;
+	if (paste.compare(paste.size() - PASTE_END.size(), PASTE_END.size(), PASTE_END) != 0) return;
+
+	paste.resize(paste.size() - PASTE_END.size());
+	in_paste = false;
+	out.push_back(KeyEvent::pasted(std::move(paste)));
+	paste.clear();
+}
+
+void InputParser::feed_escape(char c, std::vector<KeyEvent>& out) {
+	escape.push_back(c);
+
+	if (escape.size() == 2) {
+		if (c == '[' || c == 'O') return;
+
+		// e.g. alt and a key, which is ESC and then the key
+		escape.clear();
+		out.push_back(KeyEvent::typed(ESC));
+		feed_byte(c, out);
+		return;
+	}
+
+	if (escape[1] == 'O') {
+		out.push_back(KeyEvent::special(get_ss3_key(c)));
+		escape.clear();
+		return;
+	}
+
+	// parameters and intermediates, until the final byte
+	if (c >= 0x20 && c <= 0x3F) {
+		// too long to be a key, so the rest of it is only skipped
+		if (escape.size() > MAX_ESCAPE_LEN) {
+			escape.pop_back();
+			escape_too_long = true;
+		}
+		return;
+	}
+
+	if (c >= 0x40 && c <= 0x7E) {
+		if (escape_too_long) {
+			out.push_back(KeyEvent::special(special_key::OTHER));
+		} else if (escape == PASTE_START) {
+			in_paste = true;
+		} else {
+			out.push_back(KeyEvent::special(get_csi_key(escape)));
+		}
+		escape.clear();
+		escape_too_long = false;
+		return;
+	}
+
+	// something that cannot be part of it cut it off
+	escape.clear();
+	escape_too_long = false;
+	out.push_back(KeyEvent::special(special_key::OTHER));
+	feed_byte(c, out);
+}
+
+void InputParser::feed_byte(unsigned char b, std::vector<KeyEvent>& out) {
+	decoder.feed(b, [this, &out](Unicode::codepoint_t codepoint) {
+		if (codepoint == ESC) {
+			escape.push_back(ESC);
+		} else if (codepoint == 0x7F || codepoint == 0x08) {
+			out.push_back(KeyEvent::special(special_key::BACKSPACE));
+		} else {
+			out.push_back(KeyEvent::typed(codepoint));
+		}
+	});
+}
+
+void InputParser::flush(std::vector<KeyEvent>& out) {
+	// a paste that never ended still gets to the app
+	if (in_paste) {
+		in_paste = false;
+		out.push_back(KeyEvent::pasted(std::move(paste)));
+		paste.clear();
+	}
+
+	if (escape.empty()) return;
+
+	if (escape_too_long) {
+		escape.clear();
+		escape_too_long = false;
+		out.push_back(KeyEvent::special(special_key::OTHER));
+		return;
+	}
+
+	out.push_back(KeyEvent::typed(ESC));
+
+	// what came after the ESC, which cannot hold another one
+	const std::string rest = escape.substr(1);
+	escape.clear();
+	for (const char c : rest) {
+		feed_byte(c, out);
+	}
+}
+
+/***** InputReader *****/
+
+InputReader::~InputReader() {
+	cancel_flush_timer();
+}
+
+void InputReader::cancel_flush_timer() {
+	if (!flush_timer_set) return;
+	events.remove_timer(flush_timer);
+	flush_timer_set = false;
+}
+
+void InputReader::dispatch() {
+	if (keys.empty()) return;
+	app->when_input(keys);
+	keys.clear();
+}
+
+bool InputReader::read_available() {
+	char buffer[16384];
+	bool at_end = false;
+
+	// The fd is ready, so the first read does not block, and FIONREAD
+	// tells whether another one would.
+	while (true) {
+		const ssize_t n = read(fd, buffer, sizeof(buffer));
+
+		if (n == -1) {
+			if (errno == EINTR) continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				errno = 0;
+				break;
+			}
+			throw std::runtime_error("read");
+		}
+
+		if (n == 0) {
+			at_end = true;
+			break;
+		}
+
+		parser.feed(buffer, n, keys);
+
+		int available = 0;
+		if (ioctl(fd, FIONREAD, &available) == -1 || available <= 0) break;
+	}
+
+	// more input came, so whatever waited for it starts waiting again
+	cancel_flush_timer();
+
+	if (at_end) {
+		parser.flush(keys);
+	} else if (parser.has_pending() || parser.is_pasting()) {
+		const std::chrono::milliseconds timeout =
+			parser.has_pending() ? escape_timeout : paste_timeout;
+
+		flush_timer = events.add_timer(timeout, std::chrono::milliseconds(0), [this]() {
+			flush_timer_set = false;
+			parser.flush(keys);
+			dispatch();
+		});
+		flush_timer_set = true;
+	}
+
+	dispatch();
+
+	return !at_end;
+}
@@ -78,7 +78,10 @@ void twig::os::subprocess::run(
 
 	pid_t pid;
 
-	twig::curses::exit();
+	// whichever backend has the terminal gives it to the child
+	const bool native = twig::term::is_in_app_mode();
+	if (native) twig::term::exit();
+	else        twig::curses::exit();
 
 	if ((pid = fork()) == -1) {
 		throw subprocess_error("fork");
@@ -95,7 +98,8 @@ void twig::os::subprocess::run(
 			throw new subprocess_error("waitpid");
 		}
 
-		twig::curses::init();
+		if (native) twig::term::init();
+		else        twig::curses::init();
 
 		return;
 	}
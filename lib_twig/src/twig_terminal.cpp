@@ -0,0 +1,609 @@
+#include "twig_terminal.hpp"
+#include "twig_app.hpp"
+#include "twig_frame_scheduler.hpp"
+
+#include <stdexcept>
+#include <iostream>
+#include <charconv>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <cassert>
+
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+using twig::widget::Widget;
+using twig::widget::Graphics;
+using twig::widget::WInt;
+using twig::widget::WDim;
+using twig::widget::WRect;
+using twig::color::Color;
+using twig::color::ColorType;
+using twig::color::ColorPair;
+
+using twig::term::Cell;
+using twig::term::CellGrid;
+using twig::term::GridGraphics;
+using twig::term::Screen;
+
+namespace Attr = twig::term::Attr;
+
+namespace {
+
+	constexpr char ESC = 0x1B;
+
+	constexpr char REPLACEMENT[] = "\xEF\xBF\xBD";
+	constexpr char REPLACEMENT_WIDE[] = "\xEF\xBF\xBD ";
+
+	// below this, every codepoint is a grapheme cluster of its own
+	constexpr Unicode::codepoint_t FIRST_JOINING_CODEPOINT = 0x0300;
+
+	// Appends the codepoints of UTF-8, with U+FFFD in place of anything
+	// that is not valid. Unlike the decoders of lib_encoding, this reuses
+	// the memory of out.
+	void decode_utf8(const char* s, size_t len, Unicode::string_t& out) {
+		out.clear();
+
+		const unsigned char* bytes = (const unsigned char*) s;
+		size_t i = 0;
+
+		while (i < len) {
+			const unsigned char b = bytes[i];
+
+			if (b < 0x80) {
+				out.push_back(b);
+				i++;
+				continue;
+			}
+
+			size_t n;
+			Unicode::codepoint_t x;
+			Unicode::codepoint_t min;
+			if ((b & 0xE0) == 0xC0)      { n = 2; x = b & 0x1F; min = 0x80; }
+			else if ((b & 0xF0) == 0xE0) { n = 3; x = b & 0x0F; min = 0x800; }
+			else if ((b & 0xF8) == 0xF0) { n = 4; x = b & 0x07; min = 0x10000; }
+			else { out.push_back(0xFFFD); i++; continue; }
+
+			size_t j = 1;
+			for (; j < n && i + j < len && (bytes[i + j] & 0xC0) == 0x80; j++) {
+				x = (x << 6) | (bytes[i + j] & 0x3F);
+			}
+
+			if (j < n || x < min || x > 0x10FFFF || (x >= 0xD800 && x <= 0xDFFF)) {
+				out.push_back(0xFFFD);
+			} else {
+				out.push_back(x);
+			}
+			i += j;
+		}
+	}
+
+	// the length of the UTF-8 of x, which is written to out
+	size_t encode_utf8(Unicode::codepoint_t x, char* out) {
+		if (x < 0x80) {
+			out[0] = x;
+			return 1;
+		} else if (x < 0x800) {
+			out[0] = 0xC0 | (x >> 6);
+			out[1] = 0x80 | (x & 0x3F);
+			return 2;
+		} else if (x < 0x10000) {
+			out[0] = 0xE0 | (x >> 12);
+			out[1] = 0x80 | ((x >> 6) & 0x3F);
+			out[2] = 0x80 | (x & 0x3F);
+			return 3;
+		} else {
+			out[0] = 0xF0 | (x >> 18);
+			out[1] = 0x80 | ((x >> 12) & 0x3F);
+			out[2] = 0x80 | ((x >> 6) & 0x3F);
+			out[3] = 0x80 | (x & 0x3F);
+			return 4;
+		}
+	}
+
+	void append_number(std::string& out, unsigned int x) {
+		char buffer[16];
+		const auto result = std::to_chars(buffer, buffer + sizeof(buffer), x);
+		out.append(buffer, result.ptr - buffer);
+	}
+
+	// the SGR parameters of a color, after a semicolon
+	void append_color(std::string& out, const Color& c, bool background) {
+		switch (c.color_type) {
+			case ColorType::COLOR_256:
+				if (c.color_256 < 8) {
+					out += background ? ";4" : ";3";
+					append_number(out, c.color_256);
+				} else if (c.color_256 < 16) {
+					out += background ? ";10" : ";9";
+					append_number(out, c.color_256 - 8);
+				} else {
+					out += background ? ";48;5;" : ";38;5;";
+					append_number(out, c.color_256);
+				}
+				break;
+
+			case ColorType::COLOR_RGB:
+				out += background ? ";48;2;" : ";38;2;";
+				append_number(out, c.color_rgb_r);
+				out += ';';
+				append_number(out, c.color_rgb_g);
+				out += ';';
+				append_number(out, c.color_rgb_b);
+				break;
+
+			default:
+				// the reset at the start of the SGR sequence covers it
+				break;
+		}
+	}
+
+	// Blocks until all of it is written. Stdin is never made non-blocking,
+	// since on a tty it shares that flag with stdout.
+	void write_all(int fd, const char* data, size_t len) {
+		while (len > 0) {
+			const ssize_t n = write(fd, data, len);
+			if (n == -1) {
+				if (errno == EINTR) continue;
+				throw std::runtime_error("write");
+			}
+			data += n;
+			len -= n;
+		}
+	}
+
+	inline void write_all(int fd, const char* str) {
+		write_all(fd, str, std::strlen(str));
+	}
+
+}
+
+/***** CellGrid *****/
+
+void CellGrid::resize(const WDim& new_size) {
+	size = new_size;
+	cells.assign((size_t) size.width * size.height, Cell());
+}
+
+void CellGrid::clear_rect(const WRect& r) {
+	const WRect clipped = r.intersection({ size.width, size.height });
+	if (clipped.is_zero()) return;
+
+	const WInt right = clipped.x + clipped.width;
+
+	for (WInt y = clipped.y; y < clipped.y + clipped.height; y++) {
+		if (clipped.x > 0 && at(clipped.x, y).is_continuation()) {
+			at(clipped.x - 1, y) = Cell();
+		}
+		if (right < size.width && at(right, y).is_continuation()) {
+			at(right, y) = Cell();
+		}
+
+		for (WInt x = clipped.x; x < right; x++) {
+			at(x, y) = Cell();
+		}
+	}
+}
+
+/***** GridGraphics *****/
+
+void GridGraphics::when_owner_resized(const WDim& new_size) {
+	grid.resize(new_size);
+	cursor = { 0, 0 };
+}
+
+void GridGraphics::clear_fast(void) {
+	grid.clear_rect({ grid.get_size().width, grid.get_size().height });
+	cursor = { 0, 0 };
+}
+
+void GridGraphics::clear_full(void) {
+	clear_fast();
+}
+
+void GridGraphics::clear_rect(const WRect& r) {
+	grid.clear_rect(r);
+}
+
+void GridGraphics::set_normal(void) {
+	pen.attrs = 0;
+}
+
+void GridGraphics::set_color_pair(const ColorPair &c) {
+	pen.fg = c.fg;
+	pen.bg = c.bg;
+}
+
+void GridGraphics::put(const char* text, size_t text_len, uint8_t width) {
+	const WDim& size = grid.get_size();
+
+	if (cursor.y >= size.height || cursor.x + width > size.width) {
+		cursor.x = size.width;
+		return;
+	}
+
+	if (text_len > Cell::MAX_TEXT_LEN) {
+		// a wide cluster still has to take up both columns
+		text = width == 2 ? REPLACEMENT_WIDE : REPLACEMENT;
+		text_len = std::strlen(text);
+	}
+
+	const WInt x = cursor.x;
+	const WInt y = cursor.y;
+	const WInt end = x + width;
+
+	// whatever this covers half of is blanked, see CellGrid::clear_rect
+	if (x > 0 && grid.at(x, y).is_continuation()) {
+		grid.at(x - 1, y) = Cell();
+	}
+	if (end < size.width && grid.at(end, y).is_continuation()) {
+		grid.at(end, y) = Cell();
+	}
+
+	Cell& cell = grid.at(x, y);
+	cell = pen;
+	std::memcpy(cell.text, text, text_len);
+	cell.text_len = text_len;
+	cell.width = width;
+
+	if (width == 2) {
+		Cell& second = grid.at(x + 1, y);
+		second = pen;
+		second.text_len = 0;
+		second.width = 0;
+	}
+
+	cursor.x = end;
+}
+
+void GridGraphics::add_ch(char c) {
+	if (c >= 0x20 && c < 0x7F) {
+		put(&c, 1, 1);
+	} else {
+		add_str_raw(&c, 1);
+	}
+}
+
+void GridGraphics::add_str_raw(const char* str, const size_t len) {
+	decode_utf8(str, len, decoded);
+
+	const Unicode::AmbiguousWidth ambiguous = get_ambiguous_width();
+	const Unicode::codepoint_t* s = decoded.data();
+	const size_t n = decoded.size();
+
+	char text[Cell::MAX_TEXT_LEN + 4];
+	size_t i = 0;
+
+	while (i < n) {
+		size_t end;
+		size_t width;
+
+		// the same shortcut as Unicode::get_display_width
+		if (s[i] < FIRST_JOINING_CODEPOINT
+				&& (i + 1 == n || s[i + 1] < FIRST_JOINING_CODEPOINT)) {
+			end = i + 1;
+			width = Unicode::get_display_width(s[i], ambiguous);
+		} else {
+			end = Unicode::next_grapheme_cluster_break(s, n, i);
+			width = Unicode::get_cluster_display_width(s + i, end - i, ambiguous);
+		}
+
+		size_t text_len = 0;
+		for (size_t j = i; j < end && text_len <= Cell::MAX_TEXT_LEN; j++) {
+			text_len += encode_utf8(s[j], text + text_len);
+		}
+		i = end;
+
+		// controls and lone marks have nowhere to go
+		if (width == 0) continue;
+
+		put(text, text_len, width);
+	}
+}
+
+void GridGraphics::add_render_text(const twig::text::RenderText& text) {
+	for (const auto& grapheme : text.graphemes) {
+		if (grapheme.width == 0) continue;
+		put(text.utf8.data() + grapheme.offset, grapheme.len, grapheme.width);
+	}
+}
+
+/***** Screen *****/
+
+void Screen::move_to(WInt x, WInt y) {
+	if (cursor_valid && cursor_x == x && cursor_y == y) return;
+
+	out += ESC;
+	out += '[';
+	append_number(out, y + 1);
+	out += ';';
+	append_number(out, x + 1);
+	out += 'H';
+
+	cursor_valid = true;
+	cursor_x = x;
+	cursor_y = y;
+}
+
+void Screen::set_style(const Cell& style) {
+	if (pen_valid && pen.has_same_style(style)) return;
+
+	// starting from a reset is shorter than working out what to turn off
+	out += ESC;
+	out += "[0";
+	if (style.attrs & Attr::BOLD)      out += ";1";
+	if (style.attrs & Attr::DIM)       out += ";2";
+	if (style.attrs & Attr::ITALIC)    out += ";3";
+	if (style.attrs & Attr::UNDERLINE) out += ";4";
+	if (style.attrs & Attr::BLINK)     out += ";5";
+	if (style.attrs & (Attr::REVERSE | Attr::STANDOUT)) out += ";7";
+	if (style.attrs & Attr::INVISIBLE) out += ";8";
+	append_color(out, style.fg, false);
+	append_color(out, style.bg, true);
+	out += 'm';
+
+	pen = style;
+	pen_valid = true;
+}
+
+void Screen::present(const CellGrid& back) {
+	const WDim& size = back.get_size();
+
+	out.clear();
+
+	// begin synchronized update (DEC mode 2026)
+	out += "\x1B[?2026h";
+	const size_t empty_len = out.size();
+
+	if (!front_valid || front.get_size() != size) {
+		// a cleared screen is what a blank grid stands for
+		out += "\x1B[0m\x1B[2J";
+		front.resize(size);
+		front_valid = true;
+		cursor_valid = false;
+		pen_valid = false;
+	}
+
+	for (WInt y = 0; y < size.height; y++) {
+		for (WInt x = 0; x < size.width; x++) {
+			const Cell& cell = back.at(x, y);
+			Cell& shown = front.at(x, y);
+
+			if (cell == shown) continue;
+			shown = cell;
+
+			// sent along with the cluster before it
+			if (cell.is_continuation()) continue;
+
+			// a few unchanged cells are shorter to send again than to jump
+			if (cursor_valid && cursor_y == y && x > cursor_x
+					&& x - cursor_x <= MAX_RESENT_CELLS
+					&& can_resend(back, cursor_x, x, y)) {
+				for (WInt gap_x = cursor_x; gap_x < x; gap_x++) {
+					out.append(back.at(gap_x, y).text, back.at(gap_x, y).text_len);
+				}
+				cursor_x = x;
+			}
+
+			move_to(x, y);
+			set_style(cell);
+			out.append(cell.text, cell.text_len);
+
+			cursor_x = x + cell.width;
+
+			// in the last column, terminals differ on where the cursor is
+			if (cursor_x >= size.width) cursor_valid = false;
+		}
+	}
+
+	if (out.size() == empty_len) return;
+
+	// end synchronized update
+	out += "\x1B[?2026l";
+
+	write_out();
+}
+
+bool Screen::can_resend(const CellGrid& back, WInt first, WInt end, WInt y) const {
+	if (!pen_valid) return false;
+
+	for (WInt x = first; x < end; x++) {
+		const Cell& cell = back.at(x, y);
+		if (cell.width != 1 || !pen.has_same_style(cell)) return false;
+	}
+	return true;
+}
+
+void Screen::write_out() {
+	write_all(fd, out.data(), out.size());
+}
+
+/***** running an app *****/
+
+namespace {
+
+	bool in_app_mode = false;
+	struct termios saved_termios;
+
+	Screen* active_screen = nullptr;
+	twig::EventLoop* active_loop = nullptr;
+
+	volatile sig_atomic_t resized = 0;
+
+	void when_resized(int) {
+		resized = 1;
+		if (active_loop != nullptr) active_loop->wake();
+	}
+
+	WDim get_terminal_size() {
+		struct winsize ws;
+		if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == -1 || ws.ws_col == 0 || ws.ws_row == 0) {
+			return { 80, 24 };
+		}
+		return { ws.ws_col, ws.ws_row };
+	}
+
+	inline void do_repaint(twig::TwigApp *app, Screen& screen) {
+		Widget* root_widget = app->get_root_widget();
+		assert(root_widget != nullptr);
+
+		// nothing changed since the last repaint
+		if (!root_widget->needs_repaint() && screen.is_valid()) return;
+
+		root_widget->repaint();
+		root_widget->clear_invalidation();
+
+		const GridGraphics* g = static_cast<GridGraphics*>(root_widget->get_graphics().get());
+		screen.present(g->get_grid());
+	}
+
+	inline void do_resize(twig::TwigApp *app) {
+		Widget* root_widget = app->get_root_widget();
+		assert(root_widget != nullptr);
+
+		root_widget->set_size(get_terminal_size());
+	}
+
+}
+
+void twig::term::init() {
+	if (in_app_mode) return;
+
+	if (tcgetattr(STDIN_FILENO, &saved_termios) == -1) {
+		throw std::runtime_error("tcgetattr");
+	}
+
+	struct termios raw = saved_termios;
+	cfmakeraw(&raw);
+
+	if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == -1) {
+		throw std::runtime_error("tcsetattr");
+	}
+
+	// the alternate screen, without a cursor, and with pastes marked
+	write_all(STDOUT_FILENO, "\x1B[?1049h\x1B[?25l\x1B[?2004h");
+
+	// whatever was on the screen is gone
+	if (active_screen != nullptr) {
+		active_screen->invalidate();
+	}
+
+	in_app_mode = true;
+}
+
+void twig::term::exit() {
+	if (!in_app_mode) return;
+
+	write_all(STDOUT_FILENO, "\x1B[?2004l\x1B[0m\x1B[?25h\x1B[?1049l");
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+
+	in_app_mode = false;
+}
+
+bool twig::term::is_in_app_mode() {
+	return in_app_mode;
+}
+
+int twig::term::run_twig_app(TwigApp *app) {
+
+	if (app == nullptr) {
+		throw std::runtime_error("cannot give a null pointer as an application");
+	}
+
+	if (app->get_root_widget() == nullptr) {
+		throw std::runtime_error("root widget cannot be null");
+	}
+
+	Screen screen(STDOUT_FILENO);
+	active_screen = &screen;
+
+	twig::EventLoop& events = app->get_event_loop();
+	active_loop = &events;
+
+	try {
+
+		app->when_starting();
+
+		app->get_root_widget()->set_graphics(
+				std::unique_ptr<Graphics>(new GridGraphics()));
+
+		// without SA_RESTART, so that a resize interrupts the read
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_handler = when_resized;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGWINCH, &action, nullptr);
+
+		twig::term::init();
+
+		do_resize(app);
+		do_repaint(app, screen);
+
+		bool terminal_gone = false;
+		twig::input::InputReader input(STDIN_FILENO, app, events);
+		input.set_escape_timeout(std::chrono::milliseconds(app->get_escape_timeout()));
+		input.set_paste_timeout(std::chrono::milliseconds(app->get_paste_timeout()));
+		events.watch(STDIN_FILENO, [&input, &terminal_gone]() {
+			terminal_gone = !input.read_available();
+		});
+
+		twig::FrameScheduler frames(app->get_max_fps());
+		frames.painted();
+
+		Widget* root_widget = app->get_root_widget();
+
+		// everything that happened is handled before one repaint, and
+		// resizes wait for the next frame, so that a flood of them is one
+		while (app->is_running() && !terminal_gone) {
+
+			const bool pending = resized || root_widget->needs_repaint() || !screen.is_valid();
+			const int timeout = frames.get_wait_timeout(pending, app->get_idle_timeout());
+
+			if (!events.run_once(timeout) && !pending) {
+				app->when_no_event();
+			}
+
+			if (!frames.is_due()) continue;
+
+			if (resized) {
+				resized = 0;
+				do_resize(app);
+			}
+
+			if (!root_widget->needs_repaint() && screen.is_valid()) continue;
+
+			do_repaint(app, screen);
+			frames.painted();
+
+		}
+
+		events.unwatch(STDIN_FILENO);
+
+		twig::term::exit();
+		active_screen = nullptr;
+		active_loop = nullptr;
+
+		app->when_exiting();
+
+		return 0;
+
+	} catch (const std::exception& e) {
+		events.unwatch(STDIN_FILENO);
+
+		twig::term::exit();
+		active_screen = nullptr;
+		active_loop = nullptr;
+
+		std::cerr << "Uncaught exception: " << e.what() << std::endl;
+		if (errno != 0) {
+			std::cerr << "errno " << std::to_string(errno) << ": "
+				<< std::strerror(errno) << std::endl;
+		}
+
+		return 128;
+	}
+
+}
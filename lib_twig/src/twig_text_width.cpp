@@ -0,0 +1,55 @@
+#include "twig_text_width.hpp"
+
+#include "encoding.hpp"
+
+using twig::text::RenderText;
+
+// below this, every codepoint is a grapheme cluster of its own
+constexpr Unicode::codepoint_t FIRST_JOINING_CODEPOINT = 0x0300;
+
+// how many bytes encoding::UTF8::encode writes for x
+inline size_t get_utf8_len(Unicode::codepoint_t x) {
+	if (x < 0x80) return 1;
+	if (x < 0x800) return 2;
+	if (x < 0x10000) return 3;
+	return 4;
+}
+
+RenderText::RenderText(const Unicode::string_t& s, Unicode::AmbiguousWidth ambiguous) :
+	utf8(encoding::encode(encoding::Encoding::UTF8, s)) {
+
+	const Unicode::codepoint_t* data = s.data();
+	const size_t len = s.size();
+
+	size_t offset = 0;
+	size_t i = 0;
+
+	while (i < len) {
+		size_t end;
+		size_t cluster_width;
+
+		// the same shortcut as Unicode::get_display_width
+		if (data[i] < FIRST_JOINING_CODEPOINT
+				&& (i + 1 == len || data[i + 1] < FIRST_JOINING_CODEPOINT)) {
+			end = i + 1;
+			cluster_width = Unicode::get_display_width(data[i], ambiguous);
+		} else {
+			end = Unicode::next_grapheme_cluster_break(data, len, i);
+			cluster_width = Unicode::get_cluster_display_width(data + i, end - i, ambiguous);
+		}
+
+		size_t cluster_len = 0;
+		for (; i < end; i++) {
+			cluster_len += get_utf8_len(data[i]);
+		}
+
+		graphemes.push_back({
+			(uint32_t) offset,
+			(uint16_t) cluster_len,
+			(uint8_t) cluster_width
+		});
+
+		offset += cluster_len;
+		width += cluster_width;
+	}
+}
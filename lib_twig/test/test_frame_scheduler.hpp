@@ -0,0 +1,107 @@
+#include <cxxtest/TestSuite.h>
+
+#include <chrono>
+
+#include "twig_frame_scheduler.hpp"
+
+using twig::FrameScheduler;
+
+class FrameSchedulerTestSuite : public CxxTest::TestSuite {
+	public:
+		typedef FrameScheduler::Clock Clock;
+
+		// any time well after the start of the clock
+		const Clock::time_point start = Clock::time_point() + std::chrono::hours(1);
+
+		Clock::time_point at(int ms) {
+			return start + std::chrono::milliseconds(ms);
+		}
+
+		void test_first_frame_is_due(void) {
+			FrameScheduler frames(10);
+			TS_ASSERT(frames.is_due(start));
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, start), 0);
+		}
+
+		void test_is_due(void) {
+			// a frame every 100 ms
+			FrameScheduler frames(10);
+			frames.painted(start);
+
+			TS_ASSERT(!frames.is_due(start));
+			TS_ASSERT(!frames.is_due(at(99)));
+			TS_ASSERT(frames.is_due(at(100)));
+			TS_ASSERT(frames.is_due(at(250)));
+		}
+
+		void test_wait_without_pending_frame(void) {
+			FrameScheduler frames(10);
+			frames.painted(start);
+
+			// only the idle timeout matters
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(false, 1000, at(10)), 1000);
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(false, -1, at(10)), -1);
+		}
+
+		void test_wait_with_pending_frame(void) {
+			FrameScheduler frames(10);
+			frames.painted(start);
+
+			// until the frame is due
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, at(30)), 70);
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, -1, at(30)), 70);
+
+			// or the idle timeout, if that comes first
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 20, at(30)), 20);
+
+			// already due
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, at(100)), 0);
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, at(500)), 0);
+		}
+
+		void test_wait_rounds_up(void) {
+			FrameScheduler frames(10);
+			frames.painted(start);
+
+			// waking up early would only mean waiting again
+			const Clock::time_point now = at(30) + std::chrono::microseconds(500);
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, now), 70);
+		}
+
+		void test_painted_throttles(void) {
+			FrameScheduler frames(10);
+
+			// changes every 10 ms only get painted every 100 ms
+			int painted = 0;
+			for (int ms = 0; ms < 1000; ms += 10) {
+				if (frames.is_due(at(ms))) {
+					frames.painted(at(ms));
+					painted++;
+				}
+			}
+			TS_ASSERT_EQUALS(painted, 10);
+		}
+
+		void test_paints_right_away_after_quiet_period(void) {
+			FrameScheduler frames(10);
+			frames.painted(start);
+
+			// nothing happened for a while, so a key press is painted at once
+			TS_ASSERT(frames.is_due(at(5000)));
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, at(5000)), 0);
+			frames.painted(at(5000));
+
+			// and the one right after it waits for the next frame again
+			TS_ASSERT(!frames.is_due(at(5010)));
+			TS_ASSERT_EQUALS(frames.get_wait_timeout(true, 1000, at(5010)), 90);
+		}
+
+		void test_set_max_fps(void) {
+			FrameScheduler frames(10);
+			frames.painted(start);
+			frames.set_max_fps(50);
+
+			TS_ASSERT(!frames.is_due(at(19)));
+			TS_ASSERT(frames.is_due(at(20)));
+		}
+};
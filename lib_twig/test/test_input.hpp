@@ -0,0 +1,238 @@
+#include <cxxtest/TestSuite.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "unicode.hpp"
+#include "twig_app.hpp"
+#include "twig_input.hpp"
+
+using twig::special_key;
+using twig::input::KeyEvent;
+using twig::input::InputParser;
+
+// remembers what it was given, for InputReader
+class RecordingApp : public twig::TwigApp {
+	public:
+		bool is_running() override { return true; }
+		twig::widget::Widget* get_root_widget() override { return nullptr; }
+
+		void when_typed(const Unicode::codepoint_t& input) override {
+			typed.push_back(input);
+		}
+
+		void when_pasted(const Unicode::string_t& text) override {
+			pasted.push_back(text);
+		}
+
+		Unicode::string_t typed;
+		std::vector<Unicode::string_t> pasted;
+};
+
+class InputParserTestSuite : public CxxTest::TestSuite {
+	public:
+
+		// feeds each chunk on its own, as if each came from one read
+		std::vector<KeyEvent> feed(InputParser& parser, const std::vector<std::string>& chunks) {
+			std::vector<KeyEvent> ret;
+			for (const std::string& chunk : chunks) {
+				parser.feed(chunk.data(), chunk.size(), ret);
+			}
+			return ret;
+		}
+
+		std::vector<KeyEvent> feed(const std::vector<std::string>& chunks) {
+			InputParser parser;
+			return feed(parser, chunks);
+		}
+
+		void check_typed(const KeyEvent& key, Unicode::codepoint_t codepoint) {
+			TS_ASSERT(key.type == KeyEvent::Type::TYPED);
+			TS_ASSERT_EQUALS(key.codepoint, codepoint);
+		}
+
+		void check_special(const KeyEvent& key, special_key expected) {
+			TS_ASSERT(key.type == KeyEvent::Type::SPECIAL);
+			TS_ASSERT(key.key == expected);
+		}
+
+		void check_pasted(const KeyEvent& key, const Unicode::string_t& text) {
+			TS_ASSERT(key.type == KeyEvent::Type::PASTED);
+			TS_ASSERT(key.text == text);
+		}
+
+		void test_typed(void) {
+			const auto keys = feed({ "a\x7F" });
+			TS_ASSERT_EQUALS(keys.size(), 2);
+			check_typed(keys[0], 'a');
+			check_special(keys[1], special_key::BACKSPACE);
+		}
+
+		void test_split_csi(void) {
+			InputParser parser;
+
+			auto keys = feed(parser, { "\x1B[" });
+			TS_ASSERT(keys.empty());
+			TS_ASSERT(parser.has_pending());
+
+			keys = feed(parser, { "A" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_special(keys[0], special_key::UP);
+			TS_ASSERT(!parser.has_pending());
+
+			keys = feed({ "\x1B", "[", "5", "~" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_special(keys[0], special_key::PPAGE);
+
+			keys = feed({ "\x1B[1", "5~" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_special(keys[0], special_key::F5);
+		}
+
+		void test_split_ss3(void) {
+			const auto keys = feed({ "\x1BO", "P" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_special(keys[0], special_key::F1);
+		}
+
+		void test_split_utf8(void) {
+			// EURO SIGN, and an emoji in three reads
+			const auto keys = feed({ "\xE2\x82", "\xAC", "\xF0", "\x9F\x98", "\x80" });
+			TS_ASSERT_EQUALS(keys.size(), 2);
+			check_typed(keys[0], 0x20AC);
+			check_typed(keys[1], 0x1F600);
+		}
+
+		void test_invalid_utf8(void) {
+			// a cut off sequence, a lone continuation byte and an overlong NUL
+			const auto keys = feed({ "\xC3(", "\x80", "\xC0\x80" });
+			TS_ASSERT_EQUALS(keys.size(), 4);
+			check_typed(keys[0], 0xFFFD);
+			check_typed(keys[1], '(');
+			check_typed(keys[2], 0xFFFD);
+			check_typed(keys[3], 0xFFFD);
+		}
+
+		void test_alt_key(void) {
+			const auto keys = feed({ "\x1Bx" });
+			TS_ASSERT_EQUALS(keys.size(), 2);
+			check_typed(keys[0], 0x1B);
+			check_typed(keys[1], 'x');
+		}
+
+		void test_flush_lone_escape(void) {
+			InputParser parser;
+			std::vector<KeyEvent> keys = feed(parser, { "\x1B" });
+			TS_ASSERT(keys.empty());
+			TS_ASSERT(parser.has_pending());
+
+			parser.flush(keys);
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_typed(keys[0], 0x1B);
+			TS_ASSERT(!parser.has_pending());
+
+			// what came after it was typed
+			keys.clear();
+			feed(parser, { "\x1B[" });
+			parser.flush(keys);
+			TS_ASSERT_EQUALS(keys.size(), 2);
+			check_typed(keys[0], 0x1B);
+			check_typed(keys[1], '[');
+		}
+
+		void test_too_long_escape(void) {
+			std::string s = "\x1B[";
+			for (int i = 0; i < 40; i++) {
+				s += "1;";
+			}
+			s += "mq";
+
+			// split, so that it is too long before its end comes
+			const auto keys = feed({ s.substr(0, 50), s.substr(50) });
+			TS_ASSERT_EQUALS(keys.size(), 2);
+			check_special(keys[0], special_key::OTHER);
+			check_typed(keys[1], 'q');
+		}
+
+		void test_paste(void) {
+			const auto keys = feed({ "a\x1B[200~one\rtwo\xE2\x82\xAC\x1B[201~b" });
+			TS_ASSERT_EQUALS(keys.size(), 3);
+			check_typed(keys[0], 'a');
+			check_pasted(keys[1], U"one\rtwo\u20AC");
+			check_typed(keys[2], 'b');
+		}
+
+		void test_paste_end_split(void) {
+			InputParser parser;
+
+			auto keys = feed(parser, { "\x1B[200~ab", "c\x1B[2", "01" });
+			TS_ASSERT(keys.empty());
+
+			// nothing to time out while pasting
+			TS_ASSERT(!parser.has_pending());
+
+			keys = feed(parser, { "~" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_pasted(keys[0], U"abc");
+
+			// an ESC in the paste that does not end it is kept
+			keys = feed({ "\x1B[200~\x1B[A", "\x1B[201", "~" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_pasted(keys[0], U"\x1B[A");
+		}
+
+		void test_flush_unfinished_paste(void) {
+			InputParser parser;
+			std::vector<KeyEvent> keys = feed(parser, { "\x1B[200~xy\x1B[20" });
+			TS_ASSERT(keys.empty());
+
+			TS_ASSERT(parser.is_pasting());
+			TS_ASSERT(!parser.has_pending());
+
+			parser.flush(keys);
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_pasted(keys[0], U"xy\x1B[20");
+			TS_ASSERT(!parser.is_pasting());
+
+			// and it is over
+			keys = feed(parser, { "z" });
+			TS_ASSERT_EQUALS(keys.size(), 1);
+			check_typed(keys[0], 'z');
+		}
+
+		// the reader ends a paste whose end never comes after a while
+		void test_unterminated_paste(void) {
+			int fds[2];
+			TS_ASSERT_EQUALS(pipe(fds), 0);
+
+			RecordingApp app;
+			twig::EventLoop& events = app.get_event_loop();
+
+			{
+				twig::input::InputReader reader(fds[0], &app, events);
+				reader.set_paste_timeout(std::chrono::milliseconds(10));
+
+				const std::string paste = "\x1B[200~abc";
+				TS_ASSERT_EQUALS(write(fds[1], paste.data(), paste.size()), (ssize_t) paste.size());
+				TS_ASSERT(reader.read_available());
+				TS_ASSERT(app.pasted.empty());
+
+				for (int i = 0; i < 100 && app.pasted.empty(); i++) {
+					events.run_once(100);
+				}
+				TS_ASSERT_EQUALS(app.pasted.size(), 1);
+				TS_ASSERT(!app.pasted.empty() && app.pasted[0] == U"abc");
+
+				// and what comes after it is typed again
+				TS_ASSERT_EQUALS(write(fds[1], "z", 1), 1);
+				TS_ASSERT(reader.read_available());
+				TS_ASSERT(app.typed == U"z");
+			}
+
+			close(fds[0]);
+			close(fds[1]);
+		}
+};
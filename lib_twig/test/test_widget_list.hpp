@@ -0,0 +1,183 @@
+#include <cxxtest/TestSuite.h>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "twig_widget_list.hpp"
+
+using twig::widget::ListModel;
+
+// a list of the numbers from 0 up to size, which can be shrunk
+class StubListModel : public ListModel<int> {
+	public:
+		StubListModel(size_t size) : size(size) {}
+
+		size_t num_elements() override { return size; }
+		int get_element(size_t idx) override { return (int) idx; }
+
+		// drops elements from the end, keeping the selection if it is left
+		void shrink(size_t new_size) {
+			size = new_size;
+			if (selection_index >= size && size > 0) {
+				set_selection_index(size - 1);
+			}
+			scroll_to_selection();
+		}
+
+	private:
+		size_t size;
+};
+
+class ListModelTestSuite : public CxxTest::TestSuite {
+	public:
+		void test_page_down(void) {
+			StubListModel model(20);
+			model.set_page_size(5);
+
+			model.page_down();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 5);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 5);
+
+			// the selected row stays where it is on the screen
+			model.scroll_down(2);
+			model.page_down();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 10);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 12);
+		}
+
+		void test_page_down_at_end(void) {
+			StubListModel model(12);
+			model.set_page_size(5);
+			model.set_selection_index(8);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 4);
+
+			// no empty rows are left at the bottom
+			model.page_down();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 7);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 11);
+
+			model.page_down();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 7);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 11);
+		}
+
+		void test_page_down_short_list(void) {
+			StubListModel model(3);
+			model.set_page_size(5);
+
+			model.page_down();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 2);
+		}
+
+		void test_page_up_at_top(void) {
+			StubListModel model(20);
+			model.set_page_size(5);
+			model.set_selection_index(7);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 3);
+
+			model.page_up();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 2);
+
+			model.page_up();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 0);
+		}
+
+		void test_paging_empty_list(void) {
+			StubListModel model(0);
+			model.set_page_size(5);
+
+			model.page_down();
+			model.page_up();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 0);
+		}
+
+		void test_offset_follows_selection(void) {
+			StubListModel model(20);
+			model.set_page_size(5);
+
+			// within the page nothing scrolls
+			model.scroll_down(4);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+
+			// past it, just as far as needed
+			model.scroll_down();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 1);
+
+			model.end();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 15);
+
+			model.scroll_up(3);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 15);
+
+			model.home();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+		}
+
+		void test_page_size_change(void) {
+			StubListModel model(20);
+			model.set_page_size(10);
+			model.set_selection_index(9);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+
+			// a smaller screen scrolls to keep the selection on it
+			model.set_page_size(5);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 5);
+		}
+
+		void test_shrink_below_offset(void) {
+			StubListModel model(20);
+			model.set_page_size(5);
+			model.end();
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 15);
+
+			// the selection goes along with the last element
+			model.shrink(8);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 7);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 3);
+		}
+
+		void test_shrink_keeps_selection(void) {
+			StubListModel model(20);
+			model.set_page_size(5);
+			model.end();
+			model.scroll_up(13);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 6);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 6);
+
+			// the page fills up from above, and the selection stays on it
+			model.shrink(8);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 6);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 3);
+
+			// fewer elements than rows show all of them
+			model.shrink(2);
+			TS_ASSERT_EQUALS(model.get_selection_index(), 1);
+			TS_ASSERT_EQUALS(model.get_scroll_offset(), 0);
+		}
+
+		void test_scrolling_invalidates(void) {
+			StubListModel model(20);
+			model.set_page_size(5);
+
+			std::vector<std::pair<size_t, size_t>> invalidated;
+			model.set_invalidation_listener([&invalidated](size_t first, size_t end) {
+				invalidated.emplace_back(first, end);
+			});
+
+			// moving within the page repaints the two rows only
+			model.scroll_down();
+			TS_ASSERT_EQUALS(invalidated.size(), 2);
+
+			// scrolling repaints everything
+			invalidated.clear();
+			model.page_down();
+			TS_ASSERT(!invalidated.empty());
+			TS_ASSERT_EQUALS(invalidated[0].first, 0);
+			TS_ASSERT_EQUALS(invalidated[0].second, std::numeric_limits<size_t>::max());
+		}
+};
@@ -0,0 +1,197 @@
+// Measures how long each property lookup takes, in nanoseconds per lookup,
+// for three access patterns:
+//
+//   sequential: every codepoint, in order
+//   random:     the same codepoints, shuffled
+//   text:       the codepoints of some text, a mix of scripts by default,
+//               or the UTF-8 file given as the only argument
+//
+// The results are written to stdout as CSV. They depend on the compiler
+// flags of the build, so compare them between builds made the same way.
+// See table_sizes.py for the sizes of the tables behind these lookups.
+
+#include "unicode.hpp"
+#include "unicode_bidi.hpp"
+#include "unicode_confusables.hpp"
+#include "unicode_names.hpp"
+#include "unicode_normalization.hpp"
+#include "unicode_script_runs.hpp"
+#include "unicode_search.hpp"
+#include "encoding.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Unicode::codepoint_t;
+
+namespace {
+	// each measurement is repeated, and the fastest one is reported
+	constexpr size_t ROUNDS = 5;
+
+	// the text is repeated until it is about as long as the other inputs
+	constexpr size_t TEXT_LEN = Unicode::MAX_CODEPOINT + 1;
+
+	// a bit of everything: Latin with and without accents, Greek,
+	// Cyrillic, Arabic, Hebrew, Devanagari, CJK, Hangul and emoji
+	const Unicode::string_t SAMPLE_TEXT =
+		U"The quick brown fox jumps over the lazy dog. "
+		U"Voix ambigu\u00EB d'un c\u0153ur qui au z\u00E9phyr pr\u00E9f\u00E8re les jattes de kiwis. "
+		U"\u00DCbergr\u00F6\u00DFentr\u00E4ger. "
+		U"\u039E\u03B5\u03C3\u03BA\u03B5\u03C0\u03AC\u03B6\u03C9 \u03C4\u03B7\u03BD "
+		U"\u03C8\u03C5\u03C7\u03BF\u03C6\u03B8\u03CC\u03C1\u03B1. "
+		U"\u0421\u044A\u0435\u0448\u044C \u0436\u0435 \u0435\u0449\u0451 \u044D\u0442\u0438\u0445 "
+		U"\u043C\u044F\u0433\u043A\u0438\u0445 \u0431\u0443\u043B\u043E\u043A. "
+		U"\u0635\u0650\u0641 \u062E\u064E\u0644\u0642\u064E \u062E\u064E\u0648\u0652\u062F\u0650. "
+		U"\u05D3\u05D2 \u05E1\u05E7\u05E8\u05DF \u05E9\u05D8 \u05D1\u05D9\u05DD. "
+		U"\u090B\u0937\u093F\u092F\u094B\u0902 \u0915\u094B \u0938\u0924\u093E\u0928\u0947. "
+		U"\u6211\u80FD\u541E\u4E0B\u73BB\u7483\u800C\u4E0D\u4F24\u8EAB\u4F53\u3002"
+		U"\u3044\u308D\u306F\u306B\u307B\u3078\u3068 \u30C1\u30EA\u30CC\u30EB\u30F2\u3002"
+		U"\uB2E4\uB78C\uC950 \uD5CC \uCCC7\uBC14\uD034\uC5D0 \uD0C0\uACE0\uD30C. "
+		U"\U0001F600\U0001F44D\U0001F3FD \U0001F1E9\U0001F1EA 2024-01-01 (#42)\n";
+
+	std::vector<codepoint_t> get_sequential() {
+		std::vector<codepoint_t> ret(Unicode::MAX_CODEPOINT + 1);
+		for (size_t i = 0; i < ret.size(); i++) {
+			ret[i] = static_cast<codepoint_t>(i);
+		}
+		return ret;
+	}
+
+	std::vector<codepoint_t> get_random() {
+		std::vector<codepoint_t> ret = get_sequential();
+		std::mt19937 rng(42);
+		std::shuffle(ret.begin(), ret.end(), rng);
+		return ret;
+	}
+
+	std::vector<codepoint_t> get_text(const char* path) {
+		Unicode::string_t text = SAMPLE_TEXT;
+
+		if (path != nullptr) {
+			std::ifstream file(path, std::ios::binary);
+			if (!file) {
+				throw std::runtime_error(std::string("cannot open ") + path);
+			}
+			const std::string bytes(
+					(std::istreambuf_iterator<char>(file)),
+					std::istreambuf_iterator<char>());
+			text = encoding::decode(encoding::Encoding::UTF8, bytes.data(), bytes.size());
+			if (text.empty()) {
+				throw std::runtime_error(std::string("no text in ") + path);
+			}
+		}
+
+		std::vector<codepoint_t> ret;
+		ret.reserve(TEXT_LEN + text.size());
+		while (ret.size() < TEXT_LEN) {
+			ret.insert(ret.end(), text.begin(), text.end());
+		}
+		return ret;
+	}
+
+	// keeps the results of the lookups alive, so they are not optimized away
+	volatile uint64_t sink;
+
+	template <typename Lookup>
+	double measure(const std::vector<codepoint_t>& input, Lookup lookup) {
+		double best = 0;
+
+		for (size_t round = 0; round < ROUNDS; round++) {
+			const auto start = std::chrono::steady_clock::now();
+
+			uint64_t sum = 0;
+			for (const codepoint_t x : input) {
+				sum += static_cast<uint64_t>(lookup(x));
+			}
+			sink = sum;
+
+			const auto end = std::chrono::steady_clock::now();
+			const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+			if (round == 0 || ns < best) best = ns;
+		}
+
+		return best / input.size();
+	}
+
+	struct Inputs {
+		std::vector<codepoint_t> sequential;
+		std::vector<codepoint_t> random;
+		std::vector<codepoint_t> text;
+	};
+
+	template <typename Lookup>
+	void bench(const Inputs& inputs, const char* property, Lookup lookup) {
+		printf("%s,sequential,%.2f\n", property, measure(inputs.sequential, lookup));
+		printf("%s,random,%.2f\n",     property, measure(inputs.random,     lookup));
+		printf("%s,text,%.2f\n",       property, measure(inputs.text,       lookup));
+		fflush(stdout);
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc > 2) {
+		fprintf(stderr, "usage: %s [UTF-8 text file]\n", argv[0]);
+		return 1;
+	}
+
+	const Inputs inputs = {
+		get_sequential(),
+		get_random(),
+		get_text(argc == 2 ? argv[1] : nullptr),
+	};
+
+	using namespace Unicode;
+
+	printf("property,pattern,ns_per_lookup\n");
+
+	bench(inputs, "general_category",        [](codepoint_t x) { return get_general_category(x); });
+	bench(inputs, "simple_properties",       [](codepoint_t x) { return get_simple_properties(x); });
+	bench(inputs, "east_asian_width",        [](codepoint_t x) { return get_east_asian_width(x); });
+	bench(inputs, "line_break",              [](codepoint_t x) { return get_line_break(x); });
+	bench(inputs, "script",                  [](codepoint_t x) { return get_script(x); });
+	bench(inputs, "bidi_class",              [](codepoint_t x) { return get_bidi_class(x); });
+	bench(inputs, "display_width",           [](codepoint_t x) { return get_display_width(x); });
+	bench(inputs, "hangul_syllable_type",    [](codepoint_t x) { return get_hangul_syllable_type(x); });
+	bench(inputs, "indic_syllabic_category", [](codepoint_t x) { return get_indic_syllabic_category(x); });
+	bench(inputs, "canonical_combining_class", [](codepoint_t x) { return get_canonical_combining_class(x); });
+	bench(inputs, "grapheme_cluster_break",  [](codepoint_t x) { return get_grapheme_cluster_break(x); });
+	bench(inputs, "word_break",              [](codepoint_t x) { return get_word_break(x); });
+	bench(inputs, "sentence_break",          [](codepoint_t x) { return get_sentence_break(x); });
+	bench(inputs, "simple_lowercase",        [](codepoint_t x) { return get_simple_lowercase(x); });
+	bench(inputs, "simple_uppercase",        [](codepoint_t x) { return get_simple_uppercase(x); });
+	bench(inputs, "simple_casefold",         [](codepoint_t x) { return get_simple_casefold(x); });
+	bench(inputs, "changes_when_casemapped", [](codepoint_t x) { return changes_when_casemapped(x); });
+	bench(inputs, "quick_check_nfc",         [](codepoint_t x) { return get_quick_check(x, NormalizationForm::NFC); });
+	bench(inputs, "script_extensions",       [](codepoint_t x) { return get_script_extensions(x).size(); });
+	bench(inputs, "bidi_bracket_type",       [](codepoint_t x) { return get_bidi_bracket_type(x); });
+	bench(inputs, "bidi_mirroring_glyph",    [](codepoint_t x) { return get_bidi_mirroring_glyph(x); });
+
+	// the ones that write their result to a buffer
+	bench(inputs, "decomposition", [](codepoint_t x) {
+		codepoint_t out[MAX_DECOMPOSITION_LEN];
+		return get_decomposition(x, false, out);
+	});
+	bench(inputs, "search_folding", [](codepoint_t x) {
+		codepoint_t out[MAX_SEARCH_FOLDING_LEN];
+		return get_search_folding(x, out);
+	});
+	bench(inputs, "confusable_prototype", [](codepoint_t x) {
+		codepoint_t out[MAX_CONFUSABLE_PROTOTYPE_LEN];
+		return get_confusable_prototype(x, out);
+	});
+	bench(inputs, "name", [](codepoint_t x) {
+		char out[MAX_NAME_LEN];
+		return get_name(x, out);
+	});
+
+	return 0;
+}
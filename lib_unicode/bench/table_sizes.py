@@ -0,0 +1,61 @@
+#!/usr/bin/python3
+
+# Reports how many bytes the generated tables take up in a binary, as CSV.
+# Each generator puts its tables into a namespace named after it (e.g.
+# GeneralCategoryData), so the sizes of the symbols in these namespaces are
+# added up from the symbol table. This is what ends up in the binary, unlike
+# the "Expected size" that the generators print while building.
+#
+# usage: table_sizes.py BINARY
+
+import subprocess
+import sys
+
+
+def get_table_sizes(binary):
+    output = subprocess.run(
+            ["nm", "--demangle", "--print-size", binary],
+            check=True,
+            capture_output=True,
+            text=True).stdout
+
+    # symbols with internal linkage can appear more than once, so they are
+    # only counted once per name
+    symbols = {}
+    for line in output.splitlines():
+        parts = line.split(maxsplit=3)
+        if len(parts) != 4:
+            continue
+        _, size, kind, name = parts
+
+        # only data, not the lookup functions
+        if kind.lower() not in "bdr":
+            continue
+
+        namespace = name.split("::")[0]
+        if not namespace.endswith("Data") or namespace == name:
+            continue
+
+        symbols[name] = (namespace, int(size, 16))
+
+    ret = {}
+    for namespace, size in symbols.values():
+        ret[namespace] = ret.get(namespace, 0) + size
+    return ret
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(f"usage: {sys.argv[0]} BINARY", file=sys.stderr)
+        sys.exit(1)
+
+    sizes = get_table_sizes(sys.argv[1])
+
+    print("table,bytes")
+    for namespace in sorted(sizes.keys()):
+        print(f"{namespace},{sizes[namespace]}")
+    print(f"total,{sum(sizes.values())}")
+
+
+if __name__ == '__main__':
+    main()
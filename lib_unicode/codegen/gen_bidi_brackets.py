@@ -0,0 +1,94 @@
+from megatable import MegaTable
+import ucd
+
+# The paired brackets of BidiBrackets.txt, for rule N0 of UAX #9, and the
+# mirrored glyphs of BidiMirroring.txt, for rule L4.
+#
+# Each bracket is stored as its Bidi_Paired_Bracket_Type in the low two
+# bits, then its Bidi_Paired_Bracket, then the opening bracket of its pair
+# after canonical decomposition. Brackets match if the last one is the
+# same, so that U+2329 pairs with U+3009 as well as U+232A.
+# Mirrored glyphs are stored as the difference to the codepoint.
+
+BRACKET_TYPES = { "n": 0, "o": 1, "c": 2 }
+
+
+def get_brackets():
+    decompositions = ucd.get_canonical_decompositions()
+
+    def canonical(x):
+        mapping = decompositions.get(x, [x])
+        return mapping[0] if len(mapping) == 1 else x
+
+    ret = {}
+    for parts in ucd.preprocess_parts('BidiBrackets.txt'):
+        cp = int(parts[0], 16)
+        paired = int(parts[1], 16)
+        bracket_type = parts[2].strip()
+
+        opening = cp if bracket_type == "o" else paired
+        ret[cp] = BRACKET_TYPES[bracket_type] | (paired << 2) | (canonical(opening) << 23)
+    return ret
+
+
+def get_mirroring_glyphs():
+    ret = {}
+    for parts in ucd.preprocess_parts('BidiMirroring.txt'):
+        ret[int(parts[0], 16)] = int(parts[1], 16)
+    return ret
+
+
+POSTAMBLE = """
+Unicode::BidiBracketType Unicode::get_bidi_bracket_type(Unicode::codepoint_t x) {
+return static_cast<BidiBracketType>(BidiBracketData::lookup(x) & 0x3);
+}
+
+Unicode::codepoint_t Unicode::get_bidi_paired_bracket(Unicode::codepoint_t x) {
+const uint64_t data = BidiBracketData::lookup(x);
+return data == 0 ? x : static_cast<codepoint_t>((data >> 2) & 0x1FFFFF);
+}
+
+Unicode::codepoint_t Unicode::get_bidi_bracket_pair_id(Unicode::codepoint_t x) {
+return static_cast<codepoint_t>(BidiBracketData::lookup(x) >> 23);
+}
+
+Unicode::codepoint_t Unicode::get_bidi_mirroring_glyph(Unicode::codepoint_t x) {
+return static_cast<codepoint_t>(static_cast<int32_t>(x) + BidiMirroringData::lookup(x));
+}
+"""
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_bidi.hpp\"")
+
+    brackets = MegaTable(
+            0,
+            "uint64_t",
+            "BidiBracketData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 8)
+
+    for cp, value in get_brackets().items():
+        brackets[cp] = value
+
+    size = brackets.dump_optimally()
+
+    mirroring = MegaTable(
+            0,
+            "int32_t",
+            "BidiMirroringData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 4)
+
+    for cp, glyph in get_mirroring_glyphs().items():
+        mirroring[cp] = glyph - cp
+
+    size += mirroring.dump_optimally()
+
+    print(POSTAMBLE)
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
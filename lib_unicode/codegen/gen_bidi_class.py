@@ -0,0 +1,42 @@
+from megatable import MegaTable
+import ucd
+import table_helper
+
+def get_data():
+    special_function ="""Unicode::BidiClass Unicode::trie::get_bidi_class(Unicode::codepoint_t codepoint) {
+return BidiClassData::lookup(codepoint);
+}
+
+void Unicode::get_bidi_class(const Unicode::codepoint_t* s, size_t len, Unicode::BidiClass* out) {
+BidiClassData::lookup(s, len, out);
+}"""
+
+    # unlisted codepoints are L, the derived file already lists the
+    # unassigned ones that default to R, AL, and so on
+    ret = MegaTable(
+            "L",
+            "X",
+            "BidiClassData",
+            namespace_preamble = "using X = Unicode::BidiClass;",
+            global_postamble = special_function,
+            out_of_bounds_value = "X::L",
+            value_print_converter = table_helper.prepend_x,
+            sizeof_chunk_elem = 1)
+
+    for parts in ucd.preprocess_parts('extracted/DerivedBidiClass.txt'):
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        value = parts[1].strip()
+
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = value
+
+    return ret
+
+
+def main():
+    ucd.print_codegen_header()
+    size = get_data().dump_optimally()
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
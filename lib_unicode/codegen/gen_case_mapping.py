@@ -0,0 +1,264 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# Every codepoint points to a record. Simple mappings are stored as deltas
+# (so that e.g. all of A-Z can share one record), full mappings that expand
+# into more than one codepoint are stored as offsets into a "specials" array
+# of length-prefixed codepoint sequences, with 0 meaning "none".
+
+FLAGS = {
+        'Changes_When_Lowercased' : 0b0001,
+        'Changes_When_Uppercased' : 0b0010,
+        'Changes_When_Titlecased' : 0b0100,
+        'Changes_When_Casefolded' : 0b1000,
+}
+
+# sizeof(CaseMappingData::Record)
+SIZEOF_RECORD = 28
+
+
+class CaseMappings:
+
+    def __init__(self):
+        self.simple_lower = {}
+        self.simple_upper = {}
+        self.simple_title = {}
+        self.simple_fold = {}
+        self.full_lower = {}
+        self.full_upper = {}
+        self.full_title = {}
+        self.full_fold = {}
+
+        for parts in ucd.preprocess_parts('UnicodeData.txt'):
+            cp = int(parts[0], 16)
+            if len(parts[12]) > 0: self.simple_upper[cp] = int(parts[12], 16)
+            if len(parts[13]) > 0: self.simple_lower[cp] = int(parts[13], 16)
+            if len(parts[14]) > 0: self.simple_title[cp] = int(parts[14], 16)
+
+        for parts in ucd.preprocess_parts('SpecialCasing.txt'):
+            # conditional mappings (Final_Sigma and the language-specific
+            # ones) are handled by code, if at all
+            if len(parts) > 4 and len(parts[4]) > 0:
+                continue
+
+            cp = int(parts[0], 16)
+            self.full_lower[cp] = ucd.parse_codepoint_sequence(parts[1])
+            self.full_title[cp] = ucd.parse_codepoint_sequence(parts[2])
+            self.full_upper[cp] = ucd.parse_codepoint_sequence(parts[3])
+
+        for parts in ucd.preprocess_parts('CaseFolding.txt'):
+            cp = int(parts[0], 16)
+            status = parts[1]
+            mapping = ucd.parse_codepoint_sequence(parts[2])
+
+            if status == 'C' or status == 'S':
+                self.simple_fold[cp] = mapping[0]
+            if status == 'C' or status == 'F':
+                self.full_fold[cp] = mapping
+
+    def full(self, full, simple, cp):
+        ret = full.get(cp)
+        if ret is not None:
+            return ret
+        return [simple.get(cp, cp)]
+
+    def full_lowercase(self, cp): return self.full(self.full_lower, self.simple_lower, cp)
+    def full_uppercase(self, cp): return self.full(self.full_upper, self.simple_upper, cp)
+    def full_titlecase(self, cp): return self.full(self.full_title, self.simple_title, cp)
+    def full_casefold (self, cp): return self.full(self.full_fold,  self.simple_fold,  cp)
+
+    def get_flags(self, cp, decompositions):
+        # D139 - D142, e.g. toLowercase(toNFD(X)) != toNFD(X)
+        nfd = ucd.to_nfd([cp], decompositions)
+
+        def changes(mapping_func, first_mapping_func = None):
+            if first_mapping_func is None:
+                first_mapping_func = mapping_func
+            mapped = []
+            for i, x in enumerate(nfd):
+                mapped.extend(first_mapping_func(x) if i == 0 else mapping_func(x))
+            return mapped != nfd
+
+        ret = 0
+        if changes(self.full_lowercase): ret |= FLAGS['Changes_When_Lowercased']
+        if changes(self.full_uppercase): ret |= FLAGS['Changes_When_Uppercased']
+        if changes(self.full_casefold):  ret |= FLAGS['Changes_When_Casefolded']
+
+        # toTitlecase only titlecases the start of a word, and lowercases
+        # everything after it
+        if changes(self.full_lowercase, self.full_titlecase):
+            ret |= FLAGS['Changes_When_Titlecased']
+
+        return ret
+
+    def all_codepoints(self):
+        ret = set()
+        for d in [self.simple_lower, self.simple_upper, self.simple_title,
+                self.simple_fold, self.full_lower, self.full_upper,
+                self.full_title, self.full_fold]:
+            ret.update(d.keys())
+        return ret
+
+
+def get_data():
+    mappings = CaseMappings()
+    decompositions = ucd.get_canonical_decompositions()
+
+    # precomposed characters may change case only through their
+    # decomposition, so they have to be considered too
+    candidates = mappings.all_codepoints()
+    candidates.update(decompositions.keys())
+
+    specials = [0] # offset 0 is reserved for "none"
+    special_offsets = {}
+
+    def get_special(sequence, simple):
+        if len(sequence) == 1 and sequence[0] == simple:
+            return 0
+        key = tuple(sequence)
+        if key not in special_offsets:
+            special_offsets[key] = len(specials)
+            specials.append(len(sequence))
+            specials.extend(sequence)
+        return special_offsets[key]
+
+    # record 0 is the identity mapping
+    records = [(0, 0, 0, 0, 0, 0, 0, 0, 0)]
+    record_indices = {records[0]: 0}
+
+    ret = MegaTable(
+            0,
+            "uint16_t",
+            "CaseMappingData",
+            global_postamble = POSTAMBLE,
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    for cp in sorted(candidates):
+        lower = mappings.simple_lower.get(cp, cp)
+        upper = mappings.simple_upper.get(cp, cp)
+        title = mappings.simple_title.get(cp, cp)
+        fold = mappings.simple_fold.get(cp, cp)
+
+        record = (
+                lower - cp,
+                upper - cp,
+                title - cp,
+                fold - cp,
+                get_special(mappings.full_lowercase(cp), lower),
+                get_special(mappings.full_uppercase(cp), upper),
+                get_special(mappings.full_titlecase(cp), title),
+                get_special(mappings.full_casefold(cp), fold),
+                mappings.get_flags(cp, decompositions))
+
+        if record == records[0]:
+            continue
+
+        index = record_indices.get(record)
+        if index is None:
+            index = len(records)
+            records.append(record)
+            record_indices[record] = index
+
+        ret[cp] = index
+
+    if len(specials) > 0xFFFF:
+        raise RuntimeError("too many special casings for a uint16_t offset")
+
+    return ret, records, specials
+
+
+POSTAMBLE = """
+namespace CaseMappingData {
+inline const Record& get_record(Unicode::codepoint_t cp) {
+return records[lookup(cp)];
+}
+
+inline size_t get_full(
+        Unicode::codepoint_t cp,
+        int32_t delta,
+        uint16_t special,
+        Unicode::codepoint_t* out) {
+if (special == 0) {
+out[0] = cp + delta;
+return 1;
+}
+const size_t len = specials[special];
+for (size_t i = 0; i < len; i++) {
+out[i] = specials[special + 1 + i];
+}
+return len;
+}
+}
+
+Unicode::codepoint_t Unicode::get_simple_lowercase(Unicode::codepoint_t cp) { return cp + CaseMappingData::get_record(cp).lower; }
+Unicode::codepoint_t Unicode::get_simple_uppercase(Unicode::codepoint_t cp) { return cp + CaseMappingData::get_record(cp).upper; }
+Unicode::codepoint_t Unicode::get_simple_titlecase(Unicode::codepoint_t cp) { return cp + CaseMappingData::get_record(cp).title; }
+Unicode::codepoint_t Unicode::get_simple_casefold (Unicode::codepoint_t cp) { return cp + CaseMappingData::get_record(cp).fold; }
+
+size_t Unicode::get_full_lowercase(Unicode::codepoint_t cp, Unicode::codepoint_t* out) {
+const auto& r = CaseMappingData::get_record(cp);
+return CaseMappingData::get_full(cp, r.lower, r.full_lower, out);
+}
+
+size_t Unicode::get_full_uppercase(Unicode::codepoint_t cp, Unicode::codepoint_t* out) {
+const auto& r = CaseMappingData::get_record(cp);
+return CaseMappingData::get_full(cp, r.upper, r.full_upper, out);
+}
+
+size_t Unicode::get_full_titlecase(Unicode::codepoint_t cp, Unicode::codepoint_t* out) {
+const auto& r = CaseMappingData::get_record(cp);
+return CaseMappingData::get_full(cp, r.title, r.full_title, out);
+}
+
+size_t Unicode::get_full_casefold(Unicode::codepoint_t cp, Unicode::codepoint_t* out) {
+const auto& r = CaseMappingData::get_record(cp);
+return CaseMappingData::get_full(cp, r.fold, r.full_fold, out);
+}
+
+bool Unicode::changes_when_lowercased(Unicode::codepoint_t cp) { return (CaseMappingData::get_record(cp).flags & CaseMappingData::FLAG_CHANGES_WHEN_LOWERCASED) != 0; }
+bool Unicode::changes_when_uppercased(Unicode::codepoint_t cp) { return (CaseMappingData::get_record(cp).flags & CaseMappingData::FLAG_CHANGES_WHEN_UPPERCASED) != 0; }
+bool Unicode::changes_when_titlecased(Unicode::codepoint_t cp) { return (CaseMappingData::get_record(cp).flags & CaseMappingData::FLAG_CHANGES_WHEN_TITLECASED) != 0; }
+bool Unicode::changes_when_casefolded(Unicode::codepoint_t cp) { return (CaseMappingData::get_record(cp).flags & CaseMappingData::FLAG_CHANGES_WHEN_CASEFOLDED) != 0; }
+"""
+
+
+def print_records(records, specials):
+    # the records and specials need to be visible to the lookup functions,
+    # so they get their own copy of the namespace ahead of the table
+
+    print("namespace CaseMappingData {")
+
+    for k, v in FLAGS.items():
+        print(f'constexpr uint8_t FLAG_{k.upper()} = {hex(v)};')
+
+    print("""struct Record {
+int32_t lower, upper, title, fold;
+uint16_t full_lower, full_upper, full_title, full_fold;
+uint8_t flags;
+};""")
+
+    print("const Record records[] {")
+    for r in records:
+        print("{" + ", ".join(str(x) for x in r) + "},")
+    print("};")
+
+    print_array("const Unicode::codepoint_t", "specials", specials)
+
+    print("}")
+
+
+def main():
+    ucd.print_codegen_header()
+
+    table, records, specials = get_data()
+    print_records(records, specials)
+
+    size = table.dump_optimally()
+    size += len(records) * SIZEOF_RECORD
+    size += len(specials) * 4
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,226 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# UTS #10, the Unicode Collation Algorithm, using the DUCET from allkeys.txt
+#
+# Each collation element is packed into 32 bits,
+#   primary << 16 | secondary << 5 | tertiary
+# which leaves 11 bits for secondaries and 5 for tertiaries, more than the
+# weight ranges allkeys.txt declares. The variable flag (the '*') is
+# dropped, since only the non-ignorable option is implemented.
+#
+# A codepoint's entry in CollationData is
+#   offset << 6 | starts_contraction << 5 | element_count
+# where offset points into CollationElementData::elements. An entry of 0
+# means the codepoint has no mapping of its own and gets implicit weights.
+# Contractions (sequences of 2 or 3 codepoints) are in a sorted table of
+# keys, first << 42 | second << 21 | third, which is binary searched.
+
+MAX_COLLATION_ELEMENTS = 18
+
+
+def pack_element(primary, secondary, tertiary):
+    if primary > 0xFFFF or secondary > 0x7FF or tertiary > 0x1F:
+        raise RuntimeError(f"weights out of range: {primary} {secondary} {tertiary}")
+    return (primary << 16) | (secondary << 5) | tertiary
+
+
+def parse_elements(s):
+    # e.g. "[.1FA2.0020.0008][.0000.0029.0002]"
+    ret = []
+    for part in s.strip().strip('[]').split(']['):
+        weights = [int(x, 16) for x in part[1:].split('.')]
+        ret.append(pack_element(*weights))
+    return ret
+
+
+def get_ducet():
+    singles = {}
+    contractions = {}
+    implicit_ranges = []
+
+    for line in ucd.preprocess('allkeys.txt'):
+        if line.startswith('@implicitweights'):
+            # e.g. "@implicitweights 17000..18AFF; FB00"
+            parts = ucd.get_line_parts(line[len('@implicitweights'):])
+            codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+            implicit_ranges.append((codepoint_min, codepoint_max, int(parts[1], 16)))
+            continue
+
+        if line.startswith('@'):
+            continue
+
+        parts = ucd.get_line_parts(line)
+        seq = ucd.parse_codepoint_sequence(parts[0])
+        elements = parse_elements(parts[1])
+
+        if len(elements) > MAX_COLLATION_ELEMENTS:
+            raise RuntimeError(f"too many collation elements for {parts[0]}")
+
+        if len(seq) == 1:
+            singles[seq[0]] = elements
+        elif len(seq) <= 3:
+            contractions[tuple(seq)] = elements
+        else:
+            raise RuntimeError(f"contraction is too long: {parts[0]}")
+
+    return singles, contractions, implicit_ranges
+
+
+def contraction_key(seq):
+    seq = list(seq) + [0] * (3 - len(seq))
+    return (seq[0] << 42) | (seq[1] << 21) | seq[2]
+
+
+def get_tables(singles, contractions):
+    elements = []
+
+    # identical expansions are stored once
+    offsets = {}
+    def add_elements(e):
+        key = tuple(e)
+        if key not in offsets:
+            offsets[key] = len(elements)
+            elements.extend(e)
+        return offsets[key]
+
+    ret = MegaTable(
+            0,
+            "uint32_t",
+            "CollationData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 4)
+
+    starters = set(seq[0] for seq in contractions.keys())
+
+    for cp in sorted(singles.keys() | starters):
+        e = singles.get(cp, [])
+        ret[cp] = (add_elements(e) << 6) | ((cp in starters) << 5) | len(e)
+
+    keys = []
+    for seq in sorted(contractions.keys(), key=contraction_key):
+        e = contractions[seq]
+        keys.append((contraction_key(seq), (add_elements(e) << 6) | len(e)))
+
+    if len(elements) >= (1 << 26):
+        raise RuntimeError("too many collation elements for the offsets")
+
+    return ret, elements, keys
+
+
+POSTAMBLE = """
+namespace {
+Unicode::CollationElement unpack(uint32_t x) {
+return { uint16_t(x >> 16), uint16_t((x >> 5) & 0x7FF), uint8_t(x & 0x1F) };
+}
+
+size_t unpack_entry(uint32_t entry, Unicode::CollationElement* out) {
+const size_t len = entry & 0x1F;
+const uint32_t* src = &CollationElementData::elements[entry >> 6];
+for (size_t i = 0; i < len; i++) {
+out[i] = unpack(src[i]);
+}
+return len;
+}
+}
+
+bool Unicode::starts_contraction(Unicode::codepoint_t x) {
+return (CollationData::lookup(x) >> 5) & 1;
+}
+
+bool Unicode::get_ducet_elements(
+const Unicode::codepoint_t* seq,
+size_t len,
+Unicode::CollationElement* out,
+size_t* out_len) {
+
+if (len == 1) {
+const uint32_t entry = CollationData::lookup(seq[0]);
+if ((entry & 0x1F) == 0) return false;
+*out_len = unpack_entry(entry, out);
+return true;
+}
+
+if (len > 3) return false;
+
+uint64_t key = 0;
+for (size_t i = 0; i < 3; i++) {
+key = (key << 21) | (i < len ? seq[i] : 0);
+}
+
+const size_t count = sizeof(ContractionData::keys) / sizeof(ContractionData::keys[0]);
+
+size_t lo = 0;
+size_t hi = count;
+while (lo < hi) {
+const size_t mid = lo + (hi - lo) / 2;
+if (ContractionData::keys[mid] < key) {
+lo = mid + 1;
+} else {
+hi = mid;
+}
+}
+
+if (lo == count || ContractionData::keys[lo] != key) return false;
+
+*out_len = unpack_entry(ContractionData::entries[lo], out);
+return true;
+}
+"""
+
+
+def print_implicit_weights(implicit_ranges):
+    # UTS #10, section 10.1
+    print("""
+void Unicode::get_implicit_collation_elements(Unicode::codepoint_t x, Unicode::CollationElement* out) {
+uint16_t aaaa;
+uint16_t bbbb = (x & 0x7FFF) | 0x8000;
+""")
+
+    for codepoint_min, codepoint_max, base in implicit_ranges:
+        print(f"""if (x >= {hex(codepoint_min)} && x <= {hex(codepoint_max)}) {{
+aaaa = {hex(base)};
+bbbb = (x - {hex(codepoint_min)}) | 0x8000;
+}} else """)
+
+    print("""if (Unicode::is_unified_ideograph(x)
+&& ((x >= 0x4E00 && x <= 0x9FFF) || (x >= 0xF900 && x <= 0xFAFF))) {
+aaaa = 0xFB40 + (x >> 15);
+} else if (Unicode::is_unified_ideograph(x)) {
+aaaa = 0xFB80 + (x >> 15);
+} else {
+aaaa = 0xFBC0 + (x >> 15);
+}
+
+out[0] = { aaaa, 0x0020, 0x02 };
+out[1] = { bbbb, 0x0000, 0x00 };
+}""")
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_collation.hpp\"")
+
+    singles, contractions, implicit_ranges = get_ducet()
+    table, elements, keys = get_tables(singles, contractions)
+
+    print("namespace CollationElementData {")
+    print_array("const uint32_t", "elements", elements)
+    print("}")
+    size = len(elements) * 4
+
+    size += table.dump_optimally()
+
+    print("namespace ContractionData {")
+    print_array("const uint64_t", "keys", [f"{k}ULL" for k, v in keys])
+    print_array("const uint32_t", "entries", [v for k, v in keys])
+    print("}")
+    size += len(keys) * 12
+
+    print(POSTAMBLE)
+    print_implicit_weights(implicit_ranges)
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
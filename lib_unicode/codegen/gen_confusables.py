@@ -0,0 +1,92 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# The confusable prototypes from confusables.txt (UTS #39), which map each
+# codepoint that looks like something else to what it looks like, e.g.
+# U+0430 CYRILLIC SMALL LETTER A to U+0061 LATIN SMALL LETTER A. They are
+# stored like the search foldings in gen_search_folding.py, as offsets to a
+# length followed by the prototype. An offset of 0 means the codepoint is
+# its own prototype.
+
+# the ligature U+FDFA maps to 18 codepoints
+MAX_CONFUSABLE_PROTOTYPE_LEN = 18
+
+
+def get_prototypes():
+    ret = {}
+    for parts in ucd.preprocess_parts('confusables.txt'):
+        # the file starts with a byte order mark, which is left over from
+        # the comment on the first line
+        if len(parts) < 3:
+            continue
+
+        cp = int(parts[0], 16)
+        prototype = ucd.parse_codepoint_sequence(parts[1])
+
+        if len(prototype) > MAX_CONFUSABLE_PROTOTYPE_LEN:
+            raise RuntimeError(f"prototype of {hex(cp)} is too long")
+        if cp in ret:
+            raise RuntimeError(f"{hex(cp)} is listed twice")
+
+        ret[cp] = prototype
+    return ret
+
+
+POSTAMBLE = """
+size_t Unicode::get_confusable_prototype(Unicode::codepoint_t cp, Unicode::codepoint_t* out) {
+const uint16_t offset = ConfusablesData::lookup(cp);
+if (offset == 0) {
+out[0] = cp;
+return 1;
+}
+
+const size_t len = ConfusablesData::data[offset];
+for (size_t i = 0; i < len; i++) {
+out[i] = ConfusablesData::data[offset + 1 + i];
+}
+return len;
+}
+"""
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_confusables.hpp\"")
+
+    prototypes = get_prototypes()
+
+    data = [0] # offset 0 means "its own prototype"
+
+    table = MegaTable(
+            0,
+            "uint16_t",
+            "ConfusablesData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    # many codepoints share a prototype (e.g. all the ways to write "l")
+    offsets = {}
+    for cp, seq in sorted(prototypes.items()):
+        key = tuple(seq)
+        if key not in offsets:
+            offsets[key] = len(data)
+            data.append(len(seq))
+            data.extend(seq)
+        table[cp] = offsets[key]
+
+    if len(data) > 0xFFFF:
+        raise RuntimeError("too many prototypes for a uint16_t offset")
+
+    print("namespace ConfusablesData {")
+    print_array("const Unicode::codepoint_t", "data", data)
+    print("}")
+    size = len(data) * 4
+
+    size += table.dump_optimally()
+
+    print(POSTAMBLE)
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
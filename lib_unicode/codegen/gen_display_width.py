@@ -0,0 +1,103 @@
+from megatable import MegaTable
+import ucd
+
+# How many terminal columns a codepoint takes up on its own. Ambiguous
+# codepoints are resolved at runtime, see Unicode::AmbiguousWidth, and the
+# values have to match Unicode::DISPLAY_WIDTH_AMBIGUOUS.
+
+ZERO      = 0
+NARROW    = 1
+WIDE      = 2
+AMBIGUOUS = 3
+
+# General categories that are never drawn on their own
+ZERO_WIDTH_CATEGORIES = {'Mn', 'Me', 'Cf', 'Cc', 'Zl', 'Zp'}
+
+# The East_Asian_Width of unlisted codepoints in these ranges is W, see the
+# header of EastAsianWidth.txt
+WIDE_BY_DEFAULT = [
+        (0x3400, 0x4DBF),
+        (0x4E00, 0x9FFF),
+        (0xF900, 0xFAFF),
+        (0x20000, 0x2FFFD),
+        (0x30000, 0x3FFFD),
+]
+
+
+def get_data():
+    special_function = """uint8_t Unicode::trie::get_display_width_class(Unicode::codepoint_t codepoint) {
+return DisplayWidthData::lookup(codepoint);
+}"""
+
+    ret = MegaTable(
+            NARROW,
+            "uint8_t",
+            "DisplayWidthData",
+            global_postamble = special_function,
+            out_of_bounds_value = NARROW,
+            sizeof_chunk_elem = 1)
+
+    for codepoint_min, codepoint_max in WIDE_BY_DEFAULT:
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = WIDE
+
+    for parts in ucd.preprocess_parts('EastAsianWidth.txt'):
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        value = parts[1].strip()
+
+        if value in ('W', 'F'):
+            width = WIDE
+        elif value == 'A':
+            width = AMBIGUOUS
+        else:
+            width = NARROW
+
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = width
+
+    # Hangul medial vowels and final consonants join onto the leading
+    # consonant, which is already wide
+    for parts in ucd.preprocess_parts('HangulSyllableType.txt'):
+        if parts[1] not in ('V', 'T'):
+            continue
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = ZERO
+
+    for parts in ucd.preprocess_parts('DerivedCoreProperties.txt'):
+        if parts[1] != 'Default_Ignorable_Code_Point':
+            continue
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = ZERO
+
+    prepended_concatenation_marks = set()
+    for parts in ucd.preprocess_parts('PropList.txt'):
+        if parts[1] != 'Prepended_Concatenation_Mark':
+            continue
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        for i in range(codepoint_min, codepoint_max+1):
+            prepended_concatenation_marks.add(i)
+
+    for parts in ucd.preprocess_parts('UnicodeData.txt'):
+        cp = int(parts[0], 16)
+        if parts[2] not in ZERO_WIDTH_CATEGORIES:
+            continue
+
+        # these are visible, and so is the soft hyphen in most terminals
+        if cp in prepended_concatenation_marks or cp == 0x00AD:
+            ret[cp] = NARROW
+            continue
+
+        ret[cp] = ZERO
+
+    return ret
+
+
+def main():
+    ucd.print_codegen_header()
+    size = get_data().dump_optimally()
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
@@ -3,8 +3,12 @@ import ucd
 import table_helper
 
 def get_data():
-    special_function ="""Unicode::EastAsianWidth Unicode::get_east_asian_width(Unicode::codepoint_t codepoint) {
+    special_function ="""Unicode::EastAsianWidth Unicode::trie::get_east_asian_width(Unicode::codepoint_t codepoint) {
 return EastAsianWidthData::lookup(codepoint);
+}
+
+void Unicode::get_east_asian_width(const Unicode::codepoint_t* s, size_t len, Unicode::EastAsianWidth* out) {
+EastAsianWidthData::lookup(s, len, out);
 }"""
 
     ret = MegaTable(
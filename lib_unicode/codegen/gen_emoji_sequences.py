@@ -0,0 +1,171 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# The RGI emoji sequences from emoji-sequences.txt and
+# emoji-zwj-sequences.txt (UTS #51): basic emoji, keycaps, flags, tag
+# sequences, modifier sequences and ZWJ sequences, compiled into a DFA that
+# matches them a codepoint at a time.
+#
+# The sequences are put into a trie, which is then minimized by merging the
+# states that accept the same suffixes. That shrinks it a lot, since e.g.
+# the sequences for every skin tone end the same way. The transitions out of
+# the start state are a MegaTable from the first codepoint to a state. The
+# rest are stored per state, sorted by codepoint, and binary searched:
+#
+#   states[i]      the offset of the edges of state i, shifted left by one,
+#                  with the low bit set if state i accepts
+#   edge_codepoints, edge_targets
+#                  the transitions, the ones of state i go up to the offset
+#                  of state i + 1
+#
+# State 0 is the dead state, which has no transitions.
+
+FILES = ['emoji-sequences.txt', 'emoji-zwj-sequences.txt']
+
+
+def get_sequences():
+    ret = set()
+    for file in FILES:
+        for parts in ucd.preprocess_parts(file):
+            if '..' in parts[0]:
+                first, last = ucd.parse_codepoint_range(parts[0])
+                for cp in range(first, last + 1):
+                    ret.add((cp,))
+            else:
+                ret.add(tuple(ucd.parse_codepoint_sequence(parts[0])))
+    return ret
+
+
+class State:
+    def __init__(self):
+        self.accepting = False
+        self.edges = {}
+
+
+def build_trie(sequences):
+    root = State()
+    for seq in sequences:
+        state = root
+        for cp in seq:
+            if cp not in state.edges:
+                state.edges[cp] = State()
+            state = state.edges[cp]
+        state.accepting = True
+    return root
+
+
+def minimize(root):
+    # The trie has no cycles, so two states are equivalent exactly when they
+    # both accept or not, and their edges lead to equivalent states. This
+    # goes bottom up, and keeps one state per signature.
+    by_signature = {}
+
+    def visit(state):
+        for cp in state.edges:
+            state.edges[cp] = visit(state.edges[cp])
+
+        signature = (state.accepting, tuple(sorted((cp, id(x)) for cp, x in state.edges.items())))
+        if signature not in by_signature:
+            by_signature[signature] = state
+        return by_signature[signature]
+
+    for cp in root.edges:
+        root.edges[cp] = visit(root.edges[cp])
+
+
+POSTAMBLE = """
+namespace EmojiSequenceData {
+// the state after x in the given state, or 0
+size_t next_state(size_t state, Unicode::codepoint_t x) {
+const Unicode::codepoint_t* begin = &edge_codepoints[states[state] >> 1];
+const Unicode::codepoint_t* end = &edge_codepoints[states[state + 1] >> 1];
+
+while (begin < end) {
+const Unicode::codepoint_t* mid = begin + (end - begin) / 2;
+if (*mid < x) {
+begin = mid + 1;
+} else {
+end = mid;
+}
+}
+
+if (begin == &edge_codepoints[states[state + 1] >> 1] || *begin != x) return 0;
+return edge_targets[begin - edge_codepoints];
+}
+}
+
+size_t Unicode::match_emoji_sequence(const Unicode::codepoint_t* s, size_t len) {
+if (len == 0) return 0;
+
+size_t ret = 0;
+size_t state = EmojiSequenceData::lookup(s[0]);
+for (size_t i = 1; state != 0; i++) {
+if (EmojiSequenceData::states[state] & 1) ret = i;
+if (i == len) break;
+state = EmojiSequenceData::next_state(state, s[i]);
+}
+return ret;
+}
+"""
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_emoji.hpp\"")
+
+    sequences = get_sequences()
+    root = build_trie(sequences)
+    minimize(root)
+
+    # number the states breadth first, after the dead state
+    numbers = {}
+    order = []
+    queue = [root.edges[cp] for cp in sorted(root.edges)]
+    while len(queue) > 0:
+        state = queue.pop(0)
+        if id(state) in numbers:
+            continue
+        numbers[id(state)] = len(order) + 1
+        order.append(state)
+        queue.extend(state.edges[cp] for cp in sorted(state.edges))
+
+    if len(order) + 1 > 0xFFFF:
+        raise RuntimeError("too many states for a uint16_t")
+
+    states = [0]
+    edge_codepoints = []
+    edge_targets = []
+    for state in order:
+        states.append((len(edge_codepoints) << 1) | int(state.accepting))
+        for cp in sorted(state.edges):
+            edge_codepoints.append(cp)
+            edge_targets.append(numbers[id(state.edges[cp])])
+    # where the edges of the last state end
+    states.append(len(edge_codepoints) << 1)
+
+    table = MegaTable(
+            0,
+            "uint16_t",
+            "EmojiSequenceData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    for cp, state in root.edges.items():
+        table[cp] = numbers[id(state)]
+
+    print("namespace EmojiSequenceData {")
+    print_array("const uint32_t", "states", states)
+    print_array("const Unicode::codepoint_t", "edge_codepoints", edge_codepoints)
+    print_array("const uint16_t", "edge_targets", edge_targets)
+    print("}")
+    size = len(states) * 4 + len(edge_codepoints) * 4 + len(edge_targets) * 2
+
+    size += table.dump_optimally()
+
+    print(POSTAMBLE)
+
+    ucd.eprint(f"{len(sequences)} sequences, {len(order)} states")
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
@@ -6,8 +6,12 @@ def get_general_categories():
     DEFAULT_CATEGORY = 'Cn'
     fill_category = DEFAULT_CATEGORY
 
-    special_function = """Unicode::GeneralCategory Unicode::get_general_category(Unicode::codepoint_t codepoint) {
+    special_function = """Unicode::GeneralCategory Unicode::trie::get_general_category(Unicode::codepoint_t codepoint) {
 	return GeneralCategoryData::lookup(codepoint);
+}
+
+void Unicode::get_general_category(const Unicode::codepoint_t* s, size_t len, Unicode::GeneralCategory* out) {
+	GeneralCategoryData::lookup(s, len, out);
 }"""
 
     ret = MegaTable(
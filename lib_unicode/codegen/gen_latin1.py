@@ -0,0 +1,111 @@
+import ucd
+
+import gen_general_category
+import gen_simple_property
+import gen_east_asian_width
+import gen_line_break_property
+import gen_script
+import gen_bidi_class
+import gen_display_width
+
+# This generates a header with direct tables for U+0000 to U+00FF, and the
+# inline lookups that use them before falling back to the tables in the
+# auto_*.cpp files. The header is included at the end of unicode.hpp.
+
+LATIN1_MAX = 0xFF
+
+
+def print_latin1_table(c_type, name, table, converter = str):
+    values = [converter(table[i]) for i in range(LATIN1_MAX + 1)]
+    print(f"constexpr {c_type} {name}[{LATIN1_MAX + 1}] = {{")
+    for i in range(0, len(values), 8):
+        print(", ".join(values[i:i+8]) + ",")
+    print("};")
+
+
+def print_enum_lookup(c_type, func_name, table_name):
+    print(f"""
+constexpr {c_type} {func_name}(codepoint_t x) {{
+return x <= LATIN1_MAX ? Latin1::{table_name}[x] : trie::{func_name}(x);
+}}""")
+
+
+def main():
+    print("// This file is programmatically generated from data contained in the UCD")
+    print("// See https://www.unicode.org/ucd/")
+    print("// Please do not edit this file directly")
+    print("#ifndef INCLUDED_AUTO_LATIN1_HPP")
+    print("#define INCLUDED_AUTO_LATIN1_HPP")
+    print("namespace Unicode {")
+
+    print("namespace Latin1 {")
+
+    print_latin1_table(
+            "GeneralCategory", "general_category",
+            gen_general_category.get_general_categories(),
+            lambda x: "GeneralCategory::" + x)
+
+    print_latin1_table(
+            "uint64_t", "simple_properties",
+            gen_simple_property.get_simple_properties(),
+            hex)
+
+    print_latin1_table(
+            "EastAsianWidth", "east_asian_width",
+            gen_east_asian_width.get_data(),
+            lambda x: "EastAsianWidth::" + x)
+
+    print_latin1_table(
+            "LineBreak", "line_break",
+            gen_line_break_property.get_data(),
+            lambda x: "LineBreak::" + x)
+
+    print_latin1_table(
+            "Script", "script",
+            gen_script.get_data(),
+            lambda x: "Script::" + x)
+
+    print_latin1_table(
+            "BidiClass", "bidi_class",
+            gen_bidi_class.get_data(),
+            lambda x: "BidiClass::" + x)
+
+    print_latin1_table(
+            "uint8_t", "display_width",
+            gen_display_width.get_data())
+
+    print("}") # namespace Latin1
+
+    print("namespace SimplePropertyFlags {")
+    for k, v in gen_simple_property.FLAGS.items():
+        print(f"constexpr uint64_t {k.upper()} = {hex(v)};")
+    print("}")
+
+    print_enum_lookup("GeneralCategory", "get_general_category", "general_category")
+    print_enum_lookup("uint64_t", "get_simple_properties", "simple_properties")
+    print_enum_lookup("EastAsianWidth", "get_east_asian_width", "east_asian_width")
+    print_enum_lookup("LineBreak", "get_line_break", "line_break")
+    print_enum_lookup("Script", "get_script", "script")
+    print_enum_lookup("BidiClass", "get_bidi_class", "bidi_class")
+
+    for k in gen_simple_property.FLAGS.keys():
+        print(f"constexpr bool is_{k.lower()}(codepoint_t x) {{ "
+              f"return (get_simple_properties(x) & SimplePropertyFlags::{k.upper()}) != 0; }}")
+
+    print("""
+constexpr uint8_t get_display_width(codepoint_t x, AmbiguousWidth ambiguous) {
+const uint8_t ret = x <= LATIN1_MAX
+? Latin1::display_width[x]
+: trie::get_display_width_class(x);
+if (ret == DISPLAY_WIDTH_AMBIGUOUS) {
+return ambiguous == AmbiguousWidth::Wide ? 2 : 1;
+}
+return ret;
+}""")
+
+    print("}") # namespace Unicode
+    print("#endif")
+
+
+if __name__ == '__main__':
+    main()
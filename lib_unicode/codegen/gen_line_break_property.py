@@ -3,8 +3,12 @@ import ucd
 import table_helper
 
 def get_data():
-    special_function ="""Unicode::LineBreak Unicode::get_line_break(Unicode::codepoint_t codepoint) {
+    special_function ="""Unicode::LineBreak Unicode::trie::get_line_break(Unicode::codepoint_t codepoint) {
 return LineBreakData::lookup(codepoint);
+}
+
+void Unicode::get_line_break(const Unicode::codepoint_t* s, size_t len, Unicode::LineBreak* out) {
+LineBreakData::lookup(s, len, out);
 }"""
 
     ret = MegaTable(
@@ -0,0 +1,261 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# The Name property from UnicodeData.txt, compressed in two steps:
+#
+# Words: every distinct word (split at spaces) is in a dictionary, sorted
+# and front coded in blocks of WORD_BLOCK_LEN. Each word is stored as the
+# length of the prefix it shares with the word before it, the length of the
+# rest, and the rest. The first word of each block shares nothing, so any
+# word is decoded from at most WORD_BLOCK_LEN entries.
+#
+# Names: each name is a length byte followed by one code per word, where
+# the most frequent words get one byte codes and the rest two bytes. Codes
+# below one_byte_codes are a single byte; otherwise
+#   (lead - one_byte_codes) * 256 + next + one_byte_codes
+# Codes are mapped to dictionary indices with word_by_code.
+#
+# Codepoints map to an index into the names (in codepoint order) with a
+# MegaTable, so looking up a name is O(1). For the reverse direction there
+# is an open addressing hash table of name indices, using FNV-1a over the
+# name, and the name indices sorted by name for prefix searches.
+#
+# Ranges that are named algorithmically (e.g. "CJK UNIFIED IDEOGRAPH-4E00")
+# are listed with their prefix, except for Hangul syllables, which are
+# composed from the names of their jamo in names.cpp.
+
+WORD_BLOCK_LEN = 16
+
+# the longest name, see MAX_NAME_LEN in unicode_names.hpp
+MAX_NAME_LEN = 128
+
+# the labels of the ranges in UnicodeData.txt, and the prefix of their names
+RANGE_PREFIXES = {
+        "CJK Ideograph": "CJK UNIFIED IDEOGRAPH-",
+        "Tangut Ideograph": "TANGUT IDEOGRAPH-",
+        "Khitan": "KHITAN SMALL SCRIPT CHARACTER-",
+        "Nushu": "NUSHU CHARACTER-",
+}
+
+# FNV-1a, as in names.cpp
+def name_hash(name):
+    ret = 0x811C9DC5
+    for c in name.encode('ascii'):
+        ret ^= c
+        ret = (ret * 0x01000193) & 0xFFFFFFFF
+    return ret
+
+
+def get_names():
+    names = {}
+    ranges = []
+
+    range_start = None
+    for parts in ucd.preprocess_parts('UnicodeData.txt'):
+        cp = int(parts[0], 16)
+        name = parts[1]
+
+        if not name.startswith('<'):
+            names[cp] = name
+            continue
+
+        if name.endswith(', First>'):
+            range_start = cp
+        elif name.endswith(', Last>'):
+            label = name[1:-len(', Last>')]
+            for k, prefix in RANGE_PREFIXES.items():
+                if label.startswith(k):
+                    ranges.append((range_start, cp, prefix))
+                    break
+
+    return names, ranges
+
+
+def front_code(words):
+    data = []
+    block_offsets = []
+    previous = ""
+    for i, word in enumerate(words):
+        if i % WORD_BLOCK_LEN == 0:
+            block_offsets.append(len(data))
+            previous = ""
+
+        shared = 0
+        while shared < min(len(word), len(previous)) and word[shared] == previous[shared]:
+            shared += 1
+
+        rest = word[shared:]
+        data.append(shared)
+        data.append(len(rest))
+        data.extend(ord(c) for c in rest)
+        previous = word
+
+    return data, block_offsets
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_names.hpp\"")
+
+    names, ranges = get_names()
+    codepoints = sorted(names.keys())
+
+    if len(codepoints) >= 0xFFFF:
+        raise RuntimeError("too many names for a uint16_t index")
+
+    # the dictionary, and codes by frequency
+    frequencies = {}
+    for name in names.values():
+        if len(name) > MAX_NAME_LEN:
+            raise RuntimeError("name is too long: " + name)
+        for word in name.split(' '):
+            frequencies[word] = frequencies.get(word, 0) + 1
+
+    words = sorted(frequencies.keys())
+    word_index = { w: i for i, w in enumerate(words) }
+    by_frequency = sorted(words, key=lambda w: (-frequencies[w], w))
+
+    # as many one byte codes as possible, and enough lead bytes for the rest
+    lead_bytes = 0
+    while (256 - lead_bytes) + lead_bytes * 256 < len(words):
+        lead_bytes += 1
+    one_byte_codes = 256 - lead_bytes
+
+    word_by_code = [word_index[w] for w in by_frequency]
+    code_of = { w: i for i, w in enumerate(by_frequency) }
+
+    word_data, word_block_offsets = front_code(words)
+
+    # the names, in codepoint order
+    name_data = []
+    name_offsets = []
+    for cp in codepoints:
+        encoded = []
+        for word in names[cp].split(' '):
+            code = code_of[word]
+            if code < one_byte_codes:
+                encoded.append(code)
+            else:
+                code -= one_byte_codes
+                encoded.append(one_byte_codes + code // 256)
+                encoded.append(code % 256)
+
+        name_offsets.append(len(name_data))
+        name_data.append(len(encoded))
+        name_data.extend(encoded)
+
+    table = MegaTable(
+            0,
+            "uint16_t",
+            "NameData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    for i, cp in enumerate(codepoints):
+        table[cp] = i + 1
+
+    # at most half full
+    hash_len = 1
+    while hash_len < 2 * len(codepoints):
+        hash_len *= 2
+
+    hash_slots = [0] * hash_len
+    for i, cp in enumerate(codepoints):
+        slot = name_hash(names[cp]) & (hash_len - 1)
+        while hash_slots[slot] != 0:
+            slot = (slot + 1) & (hash_len - 1)
+        hash_slots[slot] = i + 1
+
+    by_name = sorted(range(len(codepoints)), key=lambda i: names[codepoints[i]])
+
+    print("namespace NameData {")
+    print(f"constexpr size_t word_block_len = {WORD_BLOCK_LEN};")
+    print(f"constexpr size_t one_byte_codes = {one_byte_codes};")
+    print_array("const uint8_t", "word_data", word_data)
+    print_array("const uint32_t", "word_block_offsets", word_block_offsets)
+    print_array("const uint16_t", "word_by_code", word_by_code)
+    print_array("const uint8_t", "name_data", name_data)
+    print_array("const uint32_t", "name_offsets", name_offsets)
+    print_array("const Unicode::codepoint_t", "codepoints", codepoints)
+    print_array("const uint16_t", "hash_slots", hash_slots)
+    print_array("const uint16_t", "by_name", by_name)
+    print_array("const Unicode::name_table::Range", "ranges",
+            [f"{{ {first}, {last}, \"{prefix}\" }}" for first, last, prefix in ranges])
+    print("}")
+
+    size = len(word_data) + len(word_block_offsets) * 4 + len(word_by_code) * 2
+    size += len(name_data) + len(name_offsets) * 4 + len(codepoints) * 4
+    size += len(hash_slots) * 2 + len(by_name) * 2
+    size += table.dump_optimally()
+
+    print(f"""
+size_t Unicode::name_table::size() {{
+return {len(codepoints)};
+}}
+
+size_t Unicode::name_table::find(Unicode::codepoint_t x) {{
+const uint16_t index = NameData::lookup(x);
+return index == 0 ? size() : index - 1;
+}}
+
+Unicode::codepoint_t Unicode::name_table::get_codepoint(size_t i) {{
+return NameData::codepoints[i];
+}}
+
+size_t Unicode::name_table::get_name(size_t i, char* out) {{
+const uint8_t* name = &NameData::name_data[NameData::name_offsets[i]];
+const uint8_t* end = name + 1 + name[0];
+
+size_t len = 0;
+for (const uint8_t* p = name + 1; p < end; p++) {{
+size_t code = *p;
+if (code >= NameData::one_byte_codes) {{
+code = (code - NameData::one_byte_codes) * 256 + *++p + NameData::one_byte_codes;
+}}
+
+if (len > 0) out[len++] = ' ';
+
+const size_t word = NameData::word_by_code[code];
+const uint8_t* entry = &NameData::word_data[NameData::word_block_offsets[word / NameData::word_block_len]];
+
+// the word is built up in place from the front coded block
+const size_t word_begin = len;
+for (size_t j = 0; j <= word % NameData::word_block_len; j++) {{
+const size_t shared = entry[0];
+const size_t rest = entry[1];
+for (size_t k = 0; k < rest; k++) {{
+out[word_begin + shared + k] = static_cast<char>(entry[2 + k]);
+}}
+len = word_begin + shared + rest;
+entry += 2 + rest;
+}}
+}}
+return len;
+}}
+
+size_t Unicode::name_table::get_hash_slot_count() {{
+return {hash_len};
+}}
+
+size_t Unicode::name_table::get_hash_slot(size_t slot) {{
+const uint16_t index = NameData::hash_slots[slot];
+return index == 0 ? size() : index - 1;
+}}
+
+size_t Unicode::name_table::get_by_name(size_t rank) {{
+return NameData::by_name[rank];
+}}
+
+size_t Unicode::name_table::get_range_count() {{
+return {len(ranges)};
+}}
+
+const Unicode::name_table::Range& Unicode::name_table::get_range(size_t i) {{
+return NameData::ranges[i];
+}}
+""")
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
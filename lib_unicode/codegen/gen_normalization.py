@@ -0,0 +1,277 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# The canonical combining class and the quick check properties share one
+# table, so that a quick check needs a single lookup per codepoint. The low
+# byte is the combining class, the high byte holds the flags below.
+
+QC_FLAGS = {
+        ('NFD_QC',  'N') : 0b000001,
+        ('NFC_QC',  'N') : 0b000010,
+        ('NFC_QC',  'M') : 0b000100,
+        ('NFKD_QC', 'N') : 0b001000,
+        ('NFKC_QC', 'N') : 0b010000,
+        ('NFKC_QC', 'M') : 0b100000,
+}
+
+# Decompositions are stored fully expanded, so there is no recursion at
+# runtime. Each codepoint with a decomposition points at a header,
+#   canonical_len | (compat_len << 8)
+# followed by the canonical and then the compatibility decomposition.
+# Hangul syllables are decomposed algorithmically and are not in here.
+
+# U+FDFA has the longest (compatibility) decomposition
+MAX_DECOMPOSITION_LEN = 18
+
+
+def get_decomposition_mappings():
+    canonical = {}
+    compat = {}
+
+    for parts in ucd.preprocess_parts('UnicodeData.txt'):
+        cp = int(parts[0], 16)
+        mapping = parts[5]
+        if len(mapping) == 0:
+            continue
+
+        if mapping.startswith('<'):
+            # e.g. "<compat> 0020 0308"
+            compat[cp] = ucd.parse_codepoint_sequence(mapping.split('>')[1])
+        else:
+            canonical[cp] = ucd.parse_codepoint_sequence(mapping)
+
+    def expand(cps, use_compat):
+        ret = []
+        for x in cps:
+            if x in canonical:
+                ret.extend(expand(canonical[x], use_compat))
+            elif use_compat and x in compat:
+                ret.extend(expand(compat[x], use_compat))
+            else:
+                ret.append(x)
+        return ret
+
+    ret = {}
+    for cp in set(canonical.keys()) | set(compat.keys()):
+        full_canonical = expand([cp], False) if cp in canonical else []
+        full_compat = expand([cp], True)
+        ret[cp] = (full_canonical, full_compat)
+
+    return canonical, ret
+
+
+def get_composition_exclusions():
+    ret = set()
+    for parts in ucd.preprocess_parts('DerivedNormalizationProps.txt'):
+        if parts[1] == 'Full_Composition_Exclusion':
+            codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+            for i in range(codepoint_min, codepoint_max+1):
+                ret.add(i)
+    return ret
+
+
+def get_properties():
+    ret = MegaTable(
+            0,
+            "uint16_t",
+            "NormalizationPropertyData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    for parts in ucd.preprocess_parts('UnicodeData.txt'):
+        ccc = int(parts[3])
+        if ccc != 0:
+            ret[int(parts[0], 16)] = ccc
+
+    for parts in ucd.preprocess_parts('DerivedNormalizationProps.txt'):
+        if len(parts) < 3:
+            continue
+
+        flag = QC_FLAGS.get((parts[1], parts[2]))
+        if flag is None:
+            continue
+
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = ret[i] | (flag << 8)
+
+    return ret
+
+
+def get_decompositions(full_mappings):
+    data = [0] # offset 0 means "no decomposition"
+
+    ret = MegaTable(
+            0,
+            "uint16_t",
+            "DecompositionData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    for cp in sorted(full_mappings.keys()):
+        canonical, compat = full_mappings[cp]
+
+        if max(len(canonical), len(compat)) > MAX_DECOMPOSITION_LEN:
+            raise RuntimeError(f"decomposition of {hex(cp)} is too long")
+
+        ret[cp] = len(data)
+        data.append(len(canonical) | (len(compat) << 8))
+        data.extend(canonical)
+        data.extend(compat)
+
+    if len(data) > 0xFFFF:
+        raise RuntimeError("too many decompositions for a uint16_t offset")
+
+    return ret, data
+
+
+def get_compositions(canonical, exclusions):
+    # primary composites, sorted by (first << 21) | second for bsearch
+    ret = []
+    for cp, mapping in canonical.items():
+        if len(mapping) != 2 or cp in exclusions:
+            continue
+        ret.append(((mapping[0] << 21) | mapping[1], cp))
+    ret.sort()
+    return ret
+
+
+POSTAMBLE = """
+namespace {
+constexpr Unicode::codepoint_t S_BASE = 0xAC00;
+constexpr Unicode::codepoint_t L_BASE = 0x1100;
+constexpr Unicode::codepoint_t V_BASE = 0x1161;
+constexpr Unicode::codepoint_t T_BASE = 0x11A7;
+constexpr Unicode::codepoint_t L_COUNT = 19;
+constexpr Unicode::codepoint_t V_COUNT = 21;
+constexpr Unicode::codepoint_t T_COUNT = 28;
+constexpr Unicode::codepoint_t N_COUNT = V_COUNT * T_COUNT;
+}
+
+uint8_t Unicode::get_canonical_combining_class(Unicode::codepoint_t cp) {
+return NormalizationPropertyData::lookup(cp) & 0xFF;
+}
+
+Unicode::QuickCheck Unicode::get_quick_check(Unicode::codepoint_t cp, Unicode::NormalizationForm form) {
+using X = Unicode::QuickCheck;
+const uint8_t flags = NormalizationPropertyData::lookup(cp) >> 8;
+switch (form) {
+case Unicode::NormalizationForm::NFD:
+return (flags & 0b000001) ? X::No : X::Yes;
+case Unicode::NormalizationForm::NFC:
+return (flags & 0b000010) ? X::No : (flags & 0b000100) ? X::Maybe : X::Yes;
+case Unicode::NormalizationForm::NFKD:
+return (flags & 0b001000) ? X::No : X::Yes;
+case Unicode::NormalizationForm::NFKC:
+return (flags & 0b010000) ? X::No : (flags & 0b100000) ? X::Maybe : X::Yes;
+}
+return X::Maybe;
+}
+
+size_t Unicode::get_decomposition(Unicode::codepoint_t cp, bool compat, Unicode::codepoint_t* out) {
+using HST = Unicode::HangulSyllableType;
+const HST hst = Unicode::get_hangul_syllable_type(cp);
+
+if (hst == HST::LV || hst == HST::LVT) {
+const Unicode::codepoint_t s_index = cp - S_BASE;
+out[0] = L_BASE + s_index / N_COUNT;
+out[1] = V_BASE + (s_index % N_COUNT) / T_COUNT;
+if (hst == HST::LV) return 2;
+out[2] = T_BASE + s_index % T_COUNT;
+return 3;
+}
+
+const uint16_t offset = DecompositionData::lookup(cp);
+if (offset == 0) return 0;
+
+const Unicode::codepoint_t header = DecompositionData::data[offset];
+const size_t canonical_len = header & 0xFF;
+const size_t compat_len = header >> 8;
+
+const Unicode::codepoint_t* src = &DecompositionData::data[offset + 1];
+size_t len = canonical_len;
+
+if (compat) {
+src += canonical_len;
+len = compat_len;
+}
+
+for (size_t i = 0; i < len; i++) {
+out[i] = src[i];
+}
+
+return len;
+}
+
+Unicode::codepoint_t Unicode::get_composition(Unicode::codepoint_t first, Unicode::codepoint_t second) {
+using HST = Unicode::HangulSyllableType;
+const HST first_hst = Unicode::get_hangul_syllable_type(first);
+
+// L + V -> LV
+if (first_hst == HST::L
+&& first - L_BASE < L_COUNT
+&& second - V_BASE < V_COUNT) {
+return S_BASE + ((first - L_BASE) * V_COUNT + (second - V_BASE)) * T_COUNT;
+}
+
+// LV + T -> LVT
+if (first_hst == HST::LV
+&& second - T_BASE - 1 < T_COUNT - 1) {
+return first + (second - T_BASE);
+}
+
+const uint64_t key = ((uint64_t) first << 21) | second;
+
+size_t lo = 0;
+size_t hi = sizeof(CompositionData::keys) / sizeof(CompositionData::keys[0]);
+
+while (lo < hi) {
+const size_t mid = lo + (hi - lo) / 2;
+if (CompositionData::keys[mid] < key) {
+lo = mid + 1;
+} else {
+hi = mid;
+}
+}
+
+if (lo < sizeof(CompositionData::keys) / sizeof(CompositionData::keys[0])
+&& CompositionData::keys[lo] == key) {
+return CompositionData::composites[lo];
+}
+
+return 0;
+}
+"""
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_normalization.hpp\"")
+
+    canonical, full_mappings = get_decomposition_mappings()
+    exclusions = get_composition_exclusions()
+
+    size = get_properties().dump_optimally()
+
+    decompositions, data = get_decompositions(full_mappings)
+
+    print("namespace DecompositionData {")
+    print_array("const Unicode::codepoint_t", "data", data)
+    print("}")
+    size += len(data) * 4
+    size += decompositions.dump_optimally()
+
+    compositions = get_compositions(canonical, exclusions)
+
+    print("namespace CompositionData {")
+    print_array("const uint64_t", "keys", [f"{k}ULL" for k, v in compositions])
+    print_array("const Unicode::codepoint_t", "composites", [v for k, v in compositions])
+    print("}")
+    size += len(compositions) * 12
+
+    print(POSTAMBLE)
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
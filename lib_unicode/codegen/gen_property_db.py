@@ -0,0 +1,151 @@
+import struct
+import sys
+
+import ucd
+
+import gen_general_category
+import gen_simple_property
+import gen_east_asian_width
+import gen_line_break_property
+import gen_script
+import gen_display_width
+
+# This writes the binary property database that Unicode::PropertyDatabase
+# maps into memory, see unicode_property_db.hpp for the layout. Everything
+# is little-endian, and every section starts on an 8 byte boundary.
+
+MAGIC = b"UNIPRDB\0"
+FORMAT_VERSION = 1
+
+CHUNK_LEN = 128
+
+HEADER_FORMAT = "<8sII16sQQ"     # magic, format version, table count,
+                                 # unicode version, payload size, checksum
+TABLE_ENTRY_FORMAT = "<IIIIQQQ"  # id, element size, chunk length, chunk
+                                 # count, out of bounds value, index
+                                 # offset, data offset
+
+# these are the ids of Unicode::PropertyDatabase::Table
+TABLE_GENERAL_CATEGORY   = 0
+TABLE_SIMPLE_PROPERTIES  = 1
+TABLE_EAST_ASIAN_WIDTH   = 2
+TABLE_LINE_BREAK         = 3
+TABLE_SCRIPT             = 4
+TABLE_DISPLAY_WIDTH      = 5
+
+
+def fnv1a_64(data):
+    ret = 0xcbf29ce484222325
+    for b in data:
+        ret ^= b
+        ret = (ret * 0x100000001b3) & 0xFFFFFFFFFFFFFFFF
+    return ret
+
+
+def align(data):
+    while len(data) % 8 != 0:
+        data.append(0)
+
+
+def enum_converter(enum_name):
+    values = {v: i for i, v in enumerate(ucd.read_enum_values(enum_name))}
+    return lambda x: values[x]
+
+
+def build_table(table, elem_size, converter):
+    # a two-stage table like MegaTable's, with the chunks deduplicated
+    chunk_format = "<" + str(CHUNK_LEN) + {1: "B", 8: "Q"}[elem_size]
+
+    chunks = {}
+    index = []
+    data = bytearray()
+
+    for start in range(0, ucd.MAX_CODEPOINT + 1, CHUNK_LEN):
+        chunk = struct.pack(
+                chunk_format,
+                *[converter(table[i]) for i in range(start, start + CHUNK_LEN)])
+
+        chunk_no = chunks.get(chunk)
+        if chunk_no is None:
+            chunk_no = len(chunks)
+            chunks[chunk] = chunk_no
+            data.extend(chunk)
+
+        index.append(chunk_no)
+
+    out_of_bounds = converter(table[ucd.MAX_CODEPOINT + 1])
+    return index, data, out_of_bounds
+
+
+def main():
+    tables = [
+            (TABLE_GENERAL_CATEGORY, 1,
+                gen_general_category.get_general_categories(),
+                enum_converter("GeneralCategory")),
+            (TABLE_SIMPLE_PROPERTIES, 8,
+                gen_simple_property.get_simple_properties(),
+                int),
+            (TABLE_EAST_ASIAN_WIDTH, 1,
+                gen_east_asian_width.get_data(),
+                enum_converter("EastAsianWidth")),
+            (TABLE_LINE_BREAK, 1,
+                gen_line_break_property.get_data(),
+                enum_converter("LineBreak")),
+            (TABLE_SCRIPT, 1,
+                gen_script.get_data(),
+                enum_converter("Script")),
+            (TABLE_DISPLAY_WIDTH, 1,
+                gen_display_width.get_data(),
+                int),
+    ]
+
+    header_len = struct.calcsize(HEADER_FORMAT)
+    directory_len = struct.calcsize(TABLE_ENTRY_FORMAT) * len(tables)
+
+    directory = bytearray()
+    payload = bytearray()
+
+    for table_id, elem_size, table, converter in tables:
+        index, data, out_of_bounds = build_table(table, elem_size, converter)
+
+        align(payload)
+        index_offset = header_len + directory_len + len(payload)
+        payload.extend(struct.pack(f"<{len(index)}I", *index))
+
+        align(payload)
+        data_offset = header_len + directory_len + len(payload)
+        payload.extend(data)
+
+        directory.extend(struct.pack(
+                TABLE_ENTRY_FORMAT,
+                table_id,
+                elem_size,
+                CHUNK_LEN,
+                len(index),
+                out_of_bounds,
+                index_offset,
+                data_offset))
+
+        ucd.eprint(f"table {table_id}: {len(index) * 4 + len(data)} bytes")
+
+    align(payload)
+
+    # the checksum covers everything after the header
+    body = bytes(directory + payload)
+
+    header = struct.pack(
+            HEADER_FORMAT,
+            MAGIC,
+            FORMAT_VERSION,
+            len(tables),
+            ucd.get_unicode_version().encode("ascii")[:15],
+            len(body),
+            fnv1a_64(body))
+
+    sys.stdout.buffer.write(header)
+    sys.stdout.buffer.write(body)
+
+    ucd.eprint("Expected size: " + str(len(header) + len(body)))
+
+if __name__ == '__main__':
+    main()
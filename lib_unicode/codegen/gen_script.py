@@ -3,8 +3,12 @@ import ucd
 import table_helper
 
 def get_data():
-    special_function ="""Unicode::Script Unicode::get_script(Unicode::codepoint_t codepoint) {
+    special_function ="""Unicode::Script Unicode::trie::get_script(Unicode::codepoint_t codepoint) {
 return ScriptData::lookup(codepoint);
+}
+
+void Unicode::get_script(const Unicode::codepoint_t* s, size_t len, Unicode::Script* out) {
+ScriptData::lookup(s, len, out);
 }"""
 
     ret = MegaTable(
@@ -0,0 +1,128 @@
+from megatable import MegaTable, print_array
+import ucd
+
+# Script_Extensions maps codepoints to sets of scripts. There are only a few
+# distinct sets, so each is stored once as a bitset over Unicode::Script, and
+# the table holds an index into them. Index 0 means the set is just the
+# codepoint's Script, which is the case for almost all of them.
+
+# codepoints per bulk lookup
+BLOCK_LEN = 64
+
+
+def get_script_aliases():
+    # maps the short script names used in ScriptExtensions.txt to the long
+    # ones used in Scripts.txt and the Script enum
+    ret = {}
+    for parts in ucd.preprocess_parts('PropertyValueAliases.txt'):
+        if parts[0].strip() == 'sc':
+            ret[parts[1].strip()] = parts[2].strip()
+    return ret
+
+
+def get_scripts():
+    ret = {}
+    for parts in ucd.preprocess_parts('Scripts.txt'):
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        for i in range(codepoint_min, codepoint_max+1):
+            ret[i] = parts[1].strip()
+    return ret
+
+
+def get_script_extensions():
+    # only the codepoints whose extensions differ from their script
+    aliases = get_script_aliases()
+    scripts = get_scripts()
+
+    ret = {}
+    for parts in ucd.preprocess_parts('ScriptExtensions.txt'):
+        codepoint_min, codepoint_max = ucd.parse_codepoint_range(parts[0])
+        value = frozenset(aliases.get(x, x) for x in parts[1].split())
+
+        for i in range(codepoint_min, codepoint_max+1):
+            if value != frozenset([scripts.get(i, "Unknown")]):
+                ret[i] = value
+
+    return ret
+
+
+POSTAMBLE = f"""
+Unicode::ScriptSet Unicode::get_script_extensions(Unicode::codepoint_t x) {{
+const uint8_t index = ScriptExtensionsData::lookup(x);
+if (index == 0) {{
+return ScriptSet::of(get_script(x));
+}}
+return ScriptExtensionsData::sets[index];
+}}
+
+void Unicode::get_script_extensions(const Unicode::codepoint_t* s, size_t len, Unicode::ScriptSet* out) {{
+uint8_t indices[{BLOCK_LEN}];
+Unicode::Script scripts[{BLOCK_LEN}];
+
+for (size_t i = 0; i < len; i += {BLOCK_LEN}) {{
+const size_t n = len - i < {BLOCK_LEN} ? len - i : {BLOCK_LEN};
+ScriptExtensionsData::lookup(s + i, n, indices);
+get_script(s + i, n, scripts);
+
+for (size_t j = 0; j < n; j++) {{
+out[i + j] = indices[j] == 0
+? ScriptSet::of(scripts[j])
+: ScriptExtensionsData::sets[indices[j]];
+}}
+}}
+}}
+"""
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_script_runs.hpp\"")
+
+    script_values = ucd.read_enum_values("Script")
+    words = (len(script_values) + 63) // 64
+
+    print(f"static_assert(Unicode::SCRIPT_COUNT == {len(script_values)}, \"the Script enum changed\");")
+
+    extensions = get_script_extensions()
+
+    sets = [None] # index 0 means "just the script"
+    indices = {}
+
+    table = MegaTable(
+            0,
+            "uint8_t",
+            "ScriptExtensionsData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 1)
+
+    for cp, value in extensions.items():
+        if value not in indices:
+            indices[value] = len(sets)
+            sets.append(value)
+        table[cp] = indices[value]
+
+    if len(sets) > 0xFF:
+        raise RuntimeError("too many distinct script extensions for a uint8_t index")
+
+    def print_set(value):
+        bits = [0] * words
+        for name in value or []:
+            if name not in script_values:
+                raise RuntimeError("unknown script: " + name)
+            i = script_values.index(name)
+            bits[i // 64] |= 1 << (i % 64)
+        return "{ { " + ", ".join(f"0x{x:X}ull" for x in bits) + " } }"
+
+    print("namespace ScriptExtensionsData {")
+    print_array("const Unicode::ScriptSet", "sets", [print_set(x) for x in sets])
+    print("}")
+    size = len(sets) * words * 8
+
+    size += table.dump_optimally()
+
+    print(POSTAMBLE)
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
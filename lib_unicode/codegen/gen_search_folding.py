@@ -0,0 +1,157 @@
+from megatable import MegaTable, print_array
+import ucd
+
+import gen_case_mapping
+import gen_general_category
+import gen_normalization
+
+# Search folding maps each codepoint to what someone would type when
+# searching for it: the compatibility decomposition, case folded, without
+# nonspacing marks, and with the substitutions below. The codepoints that
+# fold to something else are stored like the decompositions in
+# gen_normalization.py, as offsets to a length followed by the folding.
+# A length of 0 means the codepoint folds to nothing (e.g. U+0301).
+
+# the ligature U+FDFA decomposes into 18 codepoints
+MAX_SEARCH_FOLDING_LEN = 18
+
+# letters that have no decomposition, but are commonly typed as ASCII, and
+# typographic punctuation. These are applied after case folding, so only
+# the lowercase forms are needed.
+SUBSTITUTIONS = {
+        0x00E6: "ae", # LATIN SMALL LETTER AE
+        0x00F0: "d",  # LATIN SMALL LETTER ETH
+        0x00F8: "o",  # LATIN SMALL LETTER O WITH STROKE
+        0x00FE: "th", # LATIN SMALL LETTER THORN
+        0x0111: "d",  # LATIN SMALL LETTER D WITH STROKE
+        0x0127: "h",  # LATIN SMALL LETTER H WITH STROKE
+        0x0131: "i",  # LATIN SMALL LETTER DOTLESS I
+        0x0142: "l",  # LATIN SMALL LETTER L WITH STROKE
+        0x014B: "n",  # LATIN SMALL LETTER ENG
+        0x0153: "oe", # LATIN SMALL LIGATURE OE
+        0x0167: "t",  # LATIN SMALL LETTER T WITH STROKE
+        0x0180: "b",  # LATIN SMALL LETTER B WITH STROKE
+        0x01E5: "g",  # LATIN SMALL LETTER G WITH STROKE
+        0x0237: "j",  # LATIN SMALL LETTER DOTLESS J
+        0x0268: "i",  # LATIN SMALL LETTER I WITH STROKE
+        0x0289: "u",  # LATIN SMALL LETTER U BAR
+        0x2010: "-",  # HYPHEN
+        0x2011: "-",  # NON-BREAKING HYPHEN
+        0x2012: "-",  # FIGURE DASH
+        0x2013: "-",  # EN DASH
+        0x2014: "-",  # EM DASH
+        0x2212: "-",  # MINUS SIGN
+        0x2018: "'",  # LEFT SINGLE QUOTATION MARK
+        0x2019: "'",  # RIGHT SINGLE QUOTATION MARK
+        0x201A: "'",  # SINGLE LOW-9 QUOTATION MARK
+        0x2032: "'",  # PRIME
+        0x201C: "\"", # LEFT DOUBLE QUOTATION MARK
+        0x201D: "\"", # RIGHT DOUBLE QUOTATION MARK
+        0x201E: "\"", # DOUBLE LOW-9 QUOTATION MARK
+        0x2033: "\"", # DOUBLE PRIME
+}
+
+
+def get_foldings():
+    _, decompositions = gen_normalization.get_decomposition_mappings()
+    case_mappings = gen_case_mapping.CaseMappings()
+    general_categories = gen_general_category.get_general_categories()
+
+    def fold_once(seq):
+        ret = []
+        for x in seq:
+            decomposed = decompositions[x][1] if x in decompositions else [x]
+            for y in decomposed:
+                for z in case_mappings.full_casefold(y):
+                    if general_categories[z] == 'Mn':
+                        continue
+                    if z in SUBSTITUTIONS:
+                        ret.extend(ord(c) for c in SUBSTITUTIONS[z])
+                    else:
+                        ret.append(z)
+        return ret
+
+    # only codepoints that decompose, case fold, or are substituted can fold
+    # to something else, besides the marks themselves
+    candidates = set(decompositions.keys()) | case_mappings.all_codepoints() | set(SUBSTITUTIONS.keys())
+    for cp in range(ucd.MAX_CODEPOINT + 1):
+        if general_categories[cp] == 'Mn':
+            candidates.add(cp)
+
+    ret = {}
+    for cp in sorted(candidates):
+        # case folding a decomposition can expose another decomposition
+        # (e.g. U+0130), so this repeats until nothing changes
+        seq = [cp]
+        while True:
+            folded = fold_once(seq)
+            if folded == seq:
+                break
+            seq = folded
+
+        if seq != [cp]:
+            if len(seq) > MAX_SEARCH_FOLDING_LEN:
+                raise RuntimeError(f"search folding of {hex(cp)} is too long")
+            ret[cp] = seq
+
+    return ret
+
+
+POSTAMBLE = """
+size_t Unicode::get_search_folding(Unicode::codepoint_t cp, Unicode::codepoint_t* out) {
+const uint16_t offset = SearchFoldingData::lookup(cp);
+if (offset == 0) {
+out[0] = cp;
+return 1;
+}
+
+const size_t len = SearchFoldingData::data[offset];
+for (size_t i = 0; i < len; i++) {
+out[i] = SearchFoldingData::data[offset + 1 + i];
+}
+return len;
+}
+"""
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_search.hpp\"")
+
+    foldings = get_foldings()
+
+    data = [0] # offset 0 means "unchanged"
+
+    table = MegaTable(
+            0,
+            "uint16_t",
+            "SearchFoldingData",
+            out_of_bounds_value = 0,
+            sizeof_chunk_elem = 2)
+
+    # identical foldings (e.g. all the ways to write "a") are stored once
+    offsets = {}
+    for cp, seq in foldings.items():
+        key = tuple(seq)
+        if key not in offsets:
+            offsets[key] = len(data)
+            data.append(len(seq))
+            data.extend(seq)
+        table[cp] = offsets[key]
+
+    if len(data) > 0xFFFF:
+        raise RuntimeError("too many search foldings for a uint16_t offset")
+
+    print("namespace SearchFoldingData {")
+    print_array("const Unicode::codepoint_t", "data", data)
+    print("}")
+    size = len(data) * 4
+
+    size += table.dump_optimally()
+
+    print(POSTAMBLE)
+
+    ucd.eprint("Expected size: " + str(size))
+
+if __name__ == '__main__':
+    main()
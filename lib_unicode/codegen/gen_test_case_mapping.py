@@ -0,0 +1,78 @@
+import ucd
+
+SPECIAL_FUNCTIONS = """
+void check(
+        Unicode::codepoint_t cp,
+        Unicode::codepoint_t expected,
+        Unicode::codepoint_t actual,
+        const std::string &mapping_name) {
+
+    if (actual != expected) {
+        TS_FAIL("incorrect " + mapping_name + " for "
+                + Unicode::to_string(cp)
+                + ", expected " + Unicode::to_string(expected)
+                + ", got " + Unicode::to_string(actual));
+    }
+}
+
+void check_lower(Unicode::codepoint_t cp, Unicode::codepoint_t expected) {
+    check(cp, expected, Unicode::get_simple_lowercase(cp), "simple lowercase");
+    check(cp, expected, Unicode::to_lower(cp), "to_lower");
+}
+
+void check_upper(Unicode::codepoint_t cp, Unicode::codepoint_t expected) {
+    check(cp, expected, Unicode::get_simple_uppercase(cp), "simple uppercase");
+    check(cp, expected, Unicode::to_upper(cp), "to_upper");
+}
+
+void check_title(Unicode::codepoint_t cp, Unicode::codepoint_t expected) {
+    check(cp, expected, Unicode::get_simple_titlecase(cp), "simple titlecase");
+    check(cp, expected, Unicode::to_title(cp), "to_title");
+}
+
+void check_fold(Unicode::codepoint_t cp, Unicode::codepoint_t expected) {
+    check(cp, expected, Unicode::get_simple_casefold(cp), "simple casefold");
+    check(cp, expected, Unicode::casefold(cp), "casefold");
+}
+
+void check_full_fold(Unicode::codepoint_t cp, const Unicode::string_t &expected) {
+    Unicode::codepoint_t buf[Unicode::MAX_CASE_MAPPING_LEN];
+    const size_t len = Unicode::get_full_casefold(cp, buf);
+    if (Unicode::string_t(buf, len) != expected) {
+        TS_FAIL("incorrect full casefold for " + Unicode::to_string(cp));
+    }
+}
+"""
+
+def main():
+    ucd.print_codegen_header()
+    ucd.start_test_suite("CaseMapping")
+
+    print(SPECIAL_FUNCTIONS)
+
+    print("void test_simple_mappings(void) {")
+    for parts in ucd.preprocess_parts('UnicodeData.txt'):
+        cp = int(parts[0], 16)
+        if len(parts[12]) > 0: print(f"check_upper({cp}, 0x{parts[12]});")
+        if len(parts[13]) > 0: print(f"check_lower({cp}, 0x{parts[13]});")
+        if len(parts[14]) > 0: print(f"check_title({cp}, 0x{parts[14]});")
+    print("}")
+
+    print("void test_case_folding(void) {")
+    for parts in ucd.preprocess_parts('CaseFolding.txt'):
+        cp = int(parts[0], 16)
+        status = parts[1]
+        mapping = ucd.parse_codepoint_sequence(parts[2])
+
+        if status == 'C' or status == 'S':
+            print(f"check_fold({cp}, {mapping[0]});")
+        if status == 'C' or status == 'F':
+            mapping_str = ", ".join(str(x) for x in mapping)
+            print(f"check_full_fold({cp}, {{ {mapping_str} }});")
+    print("}")
+
+    ucd.end_test_suite()
+
+
+if __name__ == '__main__':
+    main()
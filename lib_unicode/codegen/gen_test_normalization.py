@@ -0,0 +1,142 @@
+import ucd
+
+# Lines per test function, to keep the generated functions a sane size
+CHUNK_LEN = 1000
+
+SPECIAL_FUNCTIONS = """
+std::string describe(const Unicode::string_t &s) {
+    std::string ret;
+    for (const Unicode::codepoint_t x : s) {
+        if (!ret.empty()) ret += " ";
+        ret += Unicode::to_string(x);
+    }
+    return ret;
+}
+
+void check_form(
+        const Unicode::string_t &source,
+        const Unicode::string_t &expected,
+        Unicode::NormalizationForm form) {
+
+    const Unicode::string_t actual = Unicode::normalize(source, form);
+
+    if (actual != expected) {
+        TS_FAIL(std::string("incorrect ") + Unicode::to_string(form)
+                + " for " + describe(source)
+                + ", expected " + describe(expected)
+                + ", got " + describe(actual));
+    }
+
+    if (!Unicode::is_normalized(expected, form)) {
+        TS_FAIL(describe(expected) + " should be in "
+                + Unicode::to_string(form));
+    }
+
+    Unicode::string_t in_place = source;
+    Unicode::normalize_in_place(in_place, form);
+    if (in_place != expected) {
+        TS_FAIL(std::string("incorrect in-place ") + Unicode::to_string(form)
+                + " for " + describe(source));
+    }
+}
+
+// The conformance checks from the header of NormalizationTest.txt
+void check(
+        const Unicode::string_t &c1,
+        const Unicode::string_t &c2,
+        const Unicode::string_t &c3,
+        const Unicode::string_t &c4,
+        const Unicode::string_t &c5) {
+
+    using Unicode::NormalizationForm;
+
+    for (const Unicode::string_t *x : { &c1, &c2, &c3 }) {
+        check_form(*x, c2, NormalizationForm::NFC);
+        check_form(*x, c3, NormalizationForm::NFD);
+    }
+
+    for (const Unicode::string_t *x : { &c4, &c5 }) {
+        check_form(*x, c4, NormalizationForm::NFC);
+        check_form(*x, c5, NormalizationForm::NFD);
+    }
+
+    for (const Unicode::string_t *x : { &c1, &c2, &c3, &c4, &c5 }) {
+        check_form(*x, c4, NormalizationForm::NFKC);
+        check_form(*x, c5, NormalizationForm::NFKD);
+    }
+}
+"""
+
+
+def to_initializer(seq_str):
+    return "{ " + ", ".join(str(x) for x in ucd.parse_codepoint_sequence(seq_str)) + " }"
+
+
+def main():
+    ucd.print_codegen_header()
+    print("#include \"unicode_normalization.hpp\"")
+    ucd.start_test_suite("Normalization")
+
+    print(SPECIAL_FUNCTIONS)
+
+    part = None
+    part1_codepoints = []
+    lines = []
+
+    for parts in ucd.preprocess_parts('NormalizationTest.txt'):
+        if parts[0].startswith('@'):
+            part = parts[0]
+            continue
+
+        if part == '@Part1':
+            part1_codepoints.extend(ucd.parse_codepoint_sequence(parts[0]))
+
+        lines.append(", ".join(to_initializer(x) for x in parts[0:5]))
+
+    for i in range(0, len(lines), CHUNK_LEN):
+        print(f"void test_conformance_{i // CHUNK_LEN}(void) {{")
+        for line in lines[i:i+CHUNK_LEN]:
+            print(f"check({line});")
+        print("}")
+
+    # Every codepoint not listed in part 1 is unchanged by all four forms
+    print("void test_unlisted_codepoints(void) {")
+    print("static const Unicode::codepoint_t listed[] = {")
+    print(", ".join(str(x) for x in sorted(set(part1_codepoints))) or "0")
+    print("};")
+    print("""
+    const size_t listed_len = sizeof(listed) / sizeof(listed[0]);
+    size_t next = 0;
+
+    for (Unicode::codepoint_t cp = 0; cp <= 0x10FFFF; cp++) {
+        if (next < listed_len && listed[next] == cp) {
+            next++;
+            continue;
+        }
+
+        // surrogates can't appear on their own in a well-formed string
+        if (cp >= 0xD800 && cp <= 0xDFFF) continue;
+
+        const Unicode::string_t s(1, cp);
+
+        for (const auto form : {
+                Unicode::NormalizationForm::NFC,
+                Unicode::NormalizationForm::NFD,
+                Unicode::NormalizationForm::NFKC,
+                Unicode::NormalizationForm::NFKD }) {
+
+            if (Unicode::normalize(s, form) != s) {
+                TS_FAIL(std::string("unlisted codepoint changed by ")
+                        + Unicode::to_string(form) + ": "
+                        + Unicode::to_string(cp));
+            }
+        }
+    }
+    """)
+    print("}")
+
+    ucd.end_test_suite()
+
+
+if __name__ == '__main__':
+    main()
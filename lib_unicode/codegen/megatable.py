@@ -161,6 +161,31 @@ class MegaTable():
                 print(f"return chunks[chunk_index][chunk_offset];")
 
             print("}") # end of enclosing function
+
+            # Neighbouring codepoints almost always share a chunk, so when
+            # looking up a whole span the chunk pointer is only re-read
+            # when it changes
+            print(f"void lookup(const {self.index_type}* in, size_t len, {self.data_type}* out) {{")
+            if self.min_index is None:
+                print(f"for (size_t n = 0; n < len; n++) out[n] = {self.out_of_bounds_value};")
+            else:
+                print(f"const {self.data_type}* chunk = chunks[0];")
+                print(f"size_t chunk_index = 0;")
+                print(f"for (size_t n = 0; n < len; n++) {{")
+                print(f"{self.index_type} i = in[n];")
+                print(f"if (i > {self.max_index}) {{ out[n] = {self.out_of_bounds_value}; continue; }}")
+                if self.min_index > 0:
+                    print(f"if (i < {self.min_index}) {{ out[n] = {self.out_of_bounds_value}; continue; }}")
+                    print(f"i -= {self.min_index};")
+                print(f"const size_t next_chunk_index = i / chunk_len;")
+                print(f"if (next_chunk_index != chunk_index) {{")
+                print(f"chunk_index = next_chunk_index;")
+                print(f"chunk = chunks[chunk_index];")
+                print(f"}}")
+                print(f"out[n] = chunk[i % chunk_len];")
+                print(f"}}")
+            print("}") # end of span lookup
+
             print("}") # end of enclosing namespace
 
             if self.global_postamble is not None:
@@ -2,6 +2,7 @@
 
 import sys
 import os
+import re
 
 
 # This file contains helpful goodies for scripts that work with the UCD
@@ -26,6 +27,10 @@ def parse_codepoint_range(range_str, splitter=".."):
         raise RuntimeError("not a range: " + range_str)
 
 
+def parse_codepoint_sequence(seq_str):
+    return [int(x, 16) for x in seq_str.split()]
+
+
 def preprocess(file):
     file = os.path.join(os.getenv("UCD_DIR"), file)
     if not os.path.exists(file):
@@ -49,6 +54,62 @@ def preprocess_parts(file):
         yield get_line_parts(ln)
 
 
+def get_canonical_decompositions():
+    # maps codepoints to their (single level) canonical decomposition
+    ret = {}
+    for parts in preprocess_parts('UnicodeData.txt'):
+        mapping = parts[5]
+        if len(mapping) == 0 or mapping.startswith('<'):
+            continue
+        ret[int(parts[0], 16)] = parse_codepoint_sequence(mapping)
+    return ret
+
+
+def to_nfd(codepoints, canonical_decompositions):
+    # recursively decomposes, but does not reorder combining marks
+    ret = []
+    for cp in codepoints:
+        mapping = canonical_decompositions.get(cp)
+        if mapping is None:
+            ret.append(cp)
+        else:
+            ret.extend(to_nfd(mapping, canonical_decompositions))
+    return ret
+
+
+def get_unicode_version():
+    # e.g. "# DerivedCoreProperties-15.1.0.txt" on the first line
+    for file in ['DerivedCoreProperties.txt', 'PropList.txt']:
+        path = os.path.join(os.getenv("UCD_DIR"), file)
+        if not os.path.exists(path):
+            continue
+        with open(path) as f:
+            match = re.search(r'-(\d+\.\d+\.\d+)\.txt', f.readline())
+            if match is not None:
+                return match.group(1)
+    return "unknown"
+
+
+def read_enum_values(enum_name):
+    # the values of "enum class <enum_name>" in unicode.hpp, in order,
+    # without the aliases
+    header = os.path.join(os.path.dirname(__file__), "..", "include", "unicode.hpp")
+    with open(header) as f:
+        text = f.read()
+
+    match = re.search(r'enum class ' + enum_name + r'\s*:\s*\w+\s*\{(.*?)\};', text, re.DOTALL)
+    if match is None:
+        raise RuntimeError("enum not found: " + enum_name)
+
+    body = re.sub(r'//[^\n]*', '', match.group(1))
+    ret = []
+    for x in body.split(','):
+        x = x.strip()
+        if len(x) > 0 and '=' not in x:
+            ret.append(x)
+    return ret
+
+
 def print_codegen_header():
     print("// This file is programmatically generated from data contained in the UCD")
     print("// See https://www.unicode.org/ucd/")
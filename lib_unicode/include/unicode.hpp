@@ -12,6 +12,10 @@ namespace Unicode {
 
 	const codepoint_t MAX_CODEPOINT = 0x10FFFF;
 
+	// Most properties of U+0000 to U+00FF are looked up in small constexpr
+	// tables that are visible to the compiler, see auto_latin1.hpp
+	constexpr codepoint_t LATIN1_MAX = 0xFF;
+
 
 	/***** General Categories *****/
 
@@ -122,7 +126,7 @@ namespace Unicode {
 			|| x == GeneralCategory::Zs;
 	}
 
-	GeneralCategory get_general_category(codepoint_t codepoint);
+	constexpr GeneralCategory get_general_category(codepoint_t codepoint);
 
 	inline bool is_other        (codepoint_t x) { return is_other        (get_general_category(x)); }
 	inline bool is_letter       (codepoint_t x) { return is_letter       (get_general_category(x)); }
@@ -193,6 +197,14 @@ namespace Unicode {
 	IndicSyllabicCategory get_indic_syllabic_category(codepoint_t codepoint);
 
 
+	/***** Canonical Combining Class *****/
+
+	// 0 is Not_Reordered, see UnicodeData.txt field 3
+	uint8_t get_canonical_combining_class(codepoint_t codepoint);
+
+	constexpr uint8_t CANONICAL_COMBINING_CLASS_VIRAMA = 9;
+
+
 	/***** Grapheme (user-perceived character) *****/
 
 	enum class GraphemeClusterBreak : uint8_t {
@@ -214,6 +226,10 @@ namespace Unicode {
 
 	GraphemeClusterBreak get_grapheme_cluster_break(codepoint_t codepoint);
 
+	// Returns the end of the extended grapheme cluster that starts at pos,
+	// which is len if it runs to the end of s. UAX #29, rules GB3 to GB13.
+	size_t next_grapheme_cluster_break(const codepoint_t* s, size_t len, size_t pos);
+
 
 	/***** Word_Break *****/
 
@@ -334,155 +350,125 @@ namespace Unicode {
 		Unknown                      = XX
 	};
 
-	LineBreak get_line_break(codepoint_t codepoint);
+	constexpr LineBreak get_line_break(codepoint_t codepoint);
 
 
-	/***** Properties *****/
-
-	// these are listed in no particular order
-	bool is_white_space                        (codepoint_t x);
-	bool is_bidi_control                       (codepoint_t x);
-	bool is_join_control                       (codepoint_t x);
-	bool is_dash                               (codepoint_t x);
-	bool is_hyphen                             (codepoint_t x);
-	bool is_quotation_mark                     (codepoint_t x);
-	bool is_terminal_punctuation               (codepoint_t x);
-	bool is_other_math                         (codepoint_t x);
-	bool is_hex_digit                          (codepoint_t x);
-	bool is_other_alphabetic                   (codepoint_t x);
-	bool is_ascii_hex_digit                    (codepoint_t x);
-	bool is_ideographic                        (codepoint_t x);
-	bool is_diacritic                          (codepoint_t x);
-	bool is_extender                           (codepoint_t x);
-	bool is_other_lowercase                    (codepoint_t x);
-	bool is_other_uppercase                    (codepoint_t x);
-	bool is_noncharacter_code_point            (codepoint_t x);
-	bool is_other_grapheme_extend              (codepoint_t x);
-	bool is_ids_binary_operator                (codepoint_t x);
-	bool is_ids_trinary_operator               (codepoint_t x);
-	bool is_radical                            (codepoint_t x);
-	bool is_unified_ideograph                  (codepoint_t x);
-	bool is_deprecated                         (codepoint_t x);
-	bool is_soft_dotted                        (codepoint_t x);
-	bool is_logical_order_exception            (codepoint_t x);
-	bool is_other_id_start                     (codepoint_t x);
-	bool is_other_id_continue                  (codepoint_t x);
-	bool is_sentence_terminal                  (codepoint_t x);
-	bool is_variation_selector                 (codepoint_t x);
-	bool is_pattern_white_space                (codepoint_t x);
-	bool is_pattern_syntax                     (codepoint_t x);
-	bool is_prepended_concatenation_mark       (codepoint_t x);
-	bool is_other_default_ignorable_code_point (codepoint_t x);
-	bool is_regional_indicator                 (codepoint_t x);
-
-	bool is_emoji                 (codepoint_t x);
-	bool is_emoji_presentation    (codepoint_t x);
-	bool is_emoji_modifier        (codepoint_t x);
-	bool is_emoji_modifier_base   (codepoint_t x);
-	bool is_emoji_component       (codepoint_t x);
-	bool is_extended_pictographic (codepoint_t x);
-
-	// derived properties
-	// they can be derived from the properties above
-	bool is_math                         (codepoint_t x);
-	bool is_alphabetic                   (codepoint_t x);
-	bool is_lowercase                    (codepoint_t x);
-	bool is_uppercase                    (codepoint_t x);
-	bool is_cased                        (codepoint_t x);
-	bool is_case_ignorable               (codepoint_t x);
-	bool changes_when_lowercased         (codepoint_t x);
-	bool changes_when_uppercased         (codepoint_t x);
-	bool changes_when_titlecased         (codepoint_t x);
-	bool changes_when_casefolded         (codepoint_t x);
-	bool changes_when_casemapped         (codepoint_t x);
-	bool is_id_start                     (codepoint_t x);
-	bool is_id_continue                  (codepoint_t x);
-	bool is_xid_start                    (codepoint_t x);
-	bool is_xid_continue                 (codepoint_t x);
-	bool is_default_ignorable_code_point (codepoint_t x);
-	bool is_grapheme_extended            (codepoint_t x);
-	bool is_grapheme_base                (codepoint_t x);
-	bool is_grapheme_link                (codepoint_t x);
+	/***** Bidirectional Text *****/
 
-	// implementations of derived properties
+	// https://www.unicode.org/reports/tr9/#Bidirectional_Character_Types
+	enum class BidiClass : uint8_t {
+		// strong
+		L, R, AL,
 
-	inline bool is_math(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return g == GeneralCategory::Sm
-			|| is_other_math(x);
-	}
+		// weak
+		EN, ES, ET, AN, CS, NSM, BN,
 
-	inline bool is_alphabetic(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return is_uppercase(x)
-			|| is_lowercase(x)
-			|| g == GeneralCategory::Lt
-			|| g == GeneralCategory::Lm
-			|| g == GeneralCategory::Lo
-			|| g == GeneralCategory::Nl
-			|| is_other_alphabetic(x);
-	}
+		// neutral
+		B, S, WS, ON,
 
-	inline bool is_lowercase(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return g == GeneralCategory::Ll
-			|| is_other_lowercase(x);
-	}
+		// explicit formatting
+		LRE, LRO, RLE, RLO, PDF, LRI, RLI, FSI, PDI,
 
-	inline bool is_uppercase(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return g == GeneralCategory::Lu
-			|| is_other_uppercase(x);
-	}
+		// aliases
+		Left_To_Right           = L,
+		Right_To_Left           = R,
+		Arabic_Letter           = AL,
+		European_Number         = EN,
+		European_Separator      = ES,
+		European_Terminator     = ET,
+		Arabic_Number           = AN,
+		Common_Separator        = CS,
+		Nonspacing_Mark         = NSM,
+		Boundary_Neutral        = BN,
+		Paragraph_Separator     = B,
+		Segment_Separator       = S,
+		White_Space             = WS,
+		Other_Neutral           = ON,
+		Left_To_Right_Embedding = LRE,
+		Left_To_Right_Override  = LRO,
+		Right_To_Left_Embedding = RLE,
+		Right_To_Left_Override  = RLO,
+		Pop_Directional_Format  = PDF,
+		Left_To_Right_Isolate   = LRI,
+		Right_To_Left_Isolate   = RLI,
+		First_Strong_Isolate    = FSI,
+		Pop_Directional_Isolate = PDI
+	};
 
-	// D135
-	inline bool is_cased(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return is_lowercase(x)
-			|| is_uppercase(x)
-			|| g == GeneralCategory::Titlecase_Letter;
-	}
+	constexpr BidiClass get_bidi_class(codepoint_t x);
 
-	// D136
-	inline bool is_case_ignorable(codepoint_t x) {
-		const auto g = get_general_category(x);
-		if (g == GeneralCategory::Mn
-				|| g == GeneralCategory::Me
-				|| g == GeneralCategory::Cf
-				|| g == GeneralCategory::Lm
-				|| g == GeneralCategory::Sk) {
-			return true;
-		}
 
-		const auto wb = get_word_break(x);
-		return wb == WordBreak::MidLetter
-			|| wb == WordBreak::MidNumLet
-			|| wb == WordBreak::Single_Quote;
-	}
+	/***** Properties *****/
 
-	// D139
-	inline bool changes_when_lowercased(codepoint_t x) {
-		// TODO true when toLowercase(toNFD(x)) != toNFD(x)
-		return false;
-	}
+	// these are listed in no particular order
+	constexpr bool is_white_space                        (codepoint_t x);
+	constexpr bool is_bidi_control                       (codepoint_t x);
+	constexpr bool is_join_control                       (codepoint_t x);
+	constexpr bool is_dash                               (codepoint_t x);
+	constexpr bool is_hyphen                             (codepoint_t x);
+	constexpr bool is_quotation_mark                     (codepoint_t x);
+	constexpr bool is_terminal_punctuation               (codepoint_t x);
+	constexpr bool is_other_math                         (codepoint_t x);
+	constexpr bool is_hex_digit                          (codepoint_t x);
+	constexpr bool is_other_alphabetic                   (codepoint_t x);
+	constexpr bool is_ascii_hex_digit                    (codepoint_t x);
+	constexpr bool is_ideographic                        (codepoint_t x);
+	constexpr bool is_diacritic                          (codepoint_t x);
+	constexpr bool is_extender                           (codepoint_t x);
+	constexpr bool is_other_lowercase                    (codepoint_t x);
+	constexpr bool is_other_uppercase                    (codepoint_t x);
+	constexpr bool is_noncharacter_code_point            (codepoint_t x);
+	constexpr bool is_other_grapheme_extend              (codepoint_t x);
+	constexpr bool is_ids_binary_operator                (codepoint_t x);
+	constexpr bool is_ids_trinary_operator               (codepoint_t x);
+	constexpr bool is_radical                            (codepoint_t x);
+	constexpr bool is_unified_ideograph                  (codepoint_t x);
+	constexpr bool is_deprecated                         (codepoint_t x);
+	constexpr bool is_soft_dotted                        (codepoint_t x);
+	constexpr bool is_logical_order_exception            (codepoint_t x);
+	constexpr bool is_other_id_start                     (codepoint_t x);
+	constexpr bool is_other_id_continue                  (codepoint_t x);
+	constexpr bool is_sentence_terminal                  (codepoint_t x);
+	constexpr bool is_variation_selector                 (codepoint_t x);
+	constexpr bool is_pattern_white_space                (codepoint_t x);
+	constexpr bool is_pattern_syntax                     (codepoint_t x);
+	constexpr bool is_prepended_concatenation_mark       (codepoint_t x);
+	constexpr bool is_other_default_ignorable_code_point (codepoint_t x);
+	constexpr bool is_regional_indicator                 (codepoint_t x);
+
+	constexpr bool is_emoji                 (codepoint_t x);
+	constexpr bool is_emoji_presentation    (codepoint_t x);
+	constexpr bool is_emoji_modifier        (codepoint_t x);
+	constexpr bool is_emoji_modifier_base   (codepoint_t x);
+	constexpr bool is_emoji_component       (codepoint_t x);
+	constexpr bool is_extended_pictographic (codepoint_t x);
 
-	// D140
-	inline bool changes_when_uppercased(codepoint_t x) {
-		// TODO true when toUpperCase(toNFD(x)) != toNFD(x)
-		return false;
-	}
+	// derived properties
+	// these are generated from DerivedCoreProperties.txt, so each of them is
+	// a single lookup rather than a composition of the properties above
+	constexpr bool is_math                         (codepoint_t x);
+	constexpr bool is_alphabetic                   (codepoint_t x);
+	constexpr bool is_lowercase                    (codepoint_t x);
+	constexpr bool is_uppercase                    (codepoint_t x);
+	constexpr bool is_cased                        (codepoint_t x);
+	constexpr bool is_case_ignorable               (codepoint_t x);
+	constexpr bool is_id_start                     (codepoint_t x);
+	constexpr bool is_id_continue                  (codepoint_t x);
+	constexpr bool is_xid_start                    (codepoint_t x);
+	constexpr bool is_xid_continue                 (codepoint_t x);
+	constexpr bool is_default_ignorable_code_point (codepoint_t x);
+	constexpr bool is_grapheme_extend              (codepoint_t x);
+	constexpr bool is_grapheme_base                (codepoint_t x);
 
-	// D141
-	inline bool changes_when_titlecased(codepoint_t x) {
-		// TODO true when toTitlecase(toNFD(x)) != toNFD(x)
-		return false;
-	}
+	bool changes_when_lowercased         (codepoint_t x);
+	bool changes_when_uppercased         (codepoint_t x);
+	bool changes_when_titlecased         (codepoint_t x);
+	bool changes_when_casefolded         (codepoint_t x);
+	bool changes_when_casemapped         (codepoint_t x);
+	bool is_grapheme_link                (codepoint_t x);
 
-	// D142
-	inline bool changes_when_casefolded(codepoint_t x) {
-		// TODO true when toCasefold(toNFD(x)) != toNFD(x)
-		return false;
-	}
+	// D139 - D142 (changes_when_lowercased etc.) are precomputed along
+	// with the case mappings, see auto_case_mapping.cpp
 
 	// D143
 	inline bool changes_when_casemapped(codepoint_t x) {
@@ -491,76 +477,9 @@ namespace Unicode {
 			|| changes_when_titlecased(x);
 	}
 
-	// UAX #31
-	inline bool is_id_start(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return (g == GeneralCategory::Lu
-				|| g == GeneralCategory::Ll
-				|| g == GeneralCategory::Lt
-				|| g == GeneralCategory::Lm
-				|| g == GeneralCategory::Lo
-				|| g == GeneralCategory::Nl
-				|| is_other_id_start(x))
-			&& !is_pattern_syntax(x)
-			&& !is_pattern_white_space(x);
-	}
-
-	// UAX #31
-	inline bool is_id_continue(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return (g == GeneralCategory::Mn
-				|| g == GeneralCategory::Mc
-				|| g == GeneralCategory::Nd
-				|| g == GeneralCategory::Pc
-				|| is_other_id_continue(x))
-			&& !is_pattern_syntax(x)
-			&& !is_pattern_white_space(x);
-	}
-
-	// UAX #15
-	inline bool is_xid_start(codepoint_t x) {
-		return false; // TODO
-	}
-
-	// UAX #15
-	inline bool is_xid_continue(codepoint_t x) {
-		return false; // TODO
-	}
-
-	inline bool is_default_ignorable_code_point(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return (is_other_default_ignorable_code_point(x)
-				|| g == GeneralCategory::Cf
-				|| is_variation_selector(x))
-			&& !is_white_space(x)
-			&& !(x >= 0xFFF9 && x <= 0xFFFB) // interlinear annotation format
-			&& !(x >= 0x13430 && x <= 0x13438) // egyptian hieroglyph format
-			&& !is_prepended_concatenation_mark(x);
-	}
-
-	inline bool is_grapheme_extend(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return g == GeneralCategory::Me
-			|| g == GeneralCategory::Mn
-			|| is_other_grapheme_extend(x);
-	}
-
-	inline bool is_grapheme_base(codepoint_t x) {
-		const auto g = get_general_category(x);
-		return (x <= 0x10FFFF)
-			&& g != GeneralCategory::Cc
-			&& g != GeneralCategory::Cf
-			&& g != GeneralCategory::Cs
-			&& g != GeneralCategory::Co
-			&& g != GeneralCategory::Cn
-			&& g != GeneralCategory::Zl
-			&& g != GeneralCategory::Zp
-			&& !is_grapheme_extend(x);
-	}
-
+	// Grapheme_Link is deprecated, and is the same as ccc=Virama
 	inline bool is_grapheme_link(codepoint_t x) {
-		// TODO return Canonical_Combining_Class=Virama
-		return false;
+		return get_canonical_combining_class(x) == CANONICAL_COMBINING_CLASS_VIRAMA;
 	}
 
 	// D49
@@ -593,6 +512,90 @@ namespace Unicode {
 	}
 
 
+	/***** Case Mapping *****/
+
+	// simple (one-to-one) mappings from UnicodeData.txt, and simple case
+	// folding (statuses C and S) from CaseFolding.txt
+	codepoint_t get_simple_lowercase (codepoint_t x);
+	codepoint_t get_simple_uppercase (codepoint_t x);
+	codepoint_t get_simple_titlecase (codepoint_t x);
+	codepoint_t get_simple_casefold  (codepoint_t x);
+
+	// full mappings, which also include the unconditional mappings in
+	// SpecialCasing.txt and case folding statuses C and F. One codepoint may
+	// map to several (e.g. U+00DF to "ss"), so these write into out, which
+	// must have room for MAX_CASE_MAPPING_LEN codepoints, and return how
+	// many were written.
+	constexpr size_t MAX_CASE_MAPPING_LEN = 3;
+
+	size_t get_full_lowercase (codepoint_t x, codepoint_t* out);
+	size_t get_full_uppercase (codepoint_t x, codepoint_t* out);
+	size_t get_full_titlecase (codepoint_t x, codepoint_t* out);
+	size_t get_full_casefold  (codepoint_t x, codepoint_t* out);
+
+	// these are the simple mappings, but ASCII and Latin-1 never have to
+	// touch the tables
+
+	inline codepoint_t to_lower(codepoint_t x) {
+		if (x < 0x80) {
+			return (x >= 'A' && x <= 'Z') ? x + 0x20 : x;
+		}
+		if (x <= 0xFF) {
+			return (x >= 0xC0 && x <= 0xDE && x != 0xD7) ? x + 0x20 : x;
+		}
+		return get_simple_lowercase(x);
+	}
+
+	inline codepoint_t to_upper(codepoint_t x) {
+		if (x < 0x80) {
+			return (x >= 'a' && x <= 'z') ? x - 0x20 : x;
+		}
+		if (x <= 0xFF) {
+			if (x >= 0xE0 && x <= 0xFE && x != 0xF7) return x - 0x20;
+			if (x == 0xB5) return 0x039C; // MICRO SIGN
+			if (x == 0xFF) return 0x0178; // LATIN SMALL LETTER Y WITH DIAERESIS
+			return x;
+		}
+		return get_simple_uppercase(x);
+	}
+
+	inline codepoint_t to_title(codepoint_t x) {
+		// there are no titlecase digraphs below U+0100
+		if (x <= 0xFF) {
+			return to_upper(x);
+		}
+		return get_simple_titlecase(x);
+	}
+
+	inline codepoint_t casefold(codepoint_t x) {
+		if (x <= 0xFF) {
+			if (x == 0xB5) return 0x03BC; // MICRO SIGN
+			return to_lower(x);
+		}
+		return get_simple_casefold(x);
+	}
+
+	// full, context-sensitive string mappings (Final_Sigma is applied when
+	// lowercasing, language-specific tailorings are not)
+	string_t to_lower (const string_t& s);
+	string_t to_upper (const string_t& s);
+	string_t casefold (const string_t& s);
+
+	// full mappings in place; these only reallocate when a codepoint
+	// actually expands (e.g. U+00DF when casefolding)
+	void to_lower_in_place (string_t& s);
+	void to_upper_in_place (string_t& s);
+	void casefold_in_place (string_t& s);
+
+	// simple mappings over a buffer, which never change its length
+	void to_lower_in_place (codepoint_t* s, size_t len);
+	void to_upper_in_place (codepoint_t* s, size_t len);
+	void casefold_in_place (codepoint_t* s, size_t len);
+
+	// compares the full case foldings of both strings without building them
+	bool equals_ignore_case(const string_t& a, const string_t& b);
+
+
 	/***** East Asian Width *****/
 
 	// contrary to the name, all characters have an East_Asian_Width property
@@ -613,7 +616,40 @@ namespace Unicode {
 		Wide      = W,
 	};
 
-	EastAsianWidth get_east_asian_width(codepoint_t x);
+	constexpr EastAsianWidth get_east_asian_width(codepoint_t x);
+
+
+	/***** Display Width *****/
+
+	// how to draw East_Asian_Width=A, which depends on the terminal's font
+	enum class AmbiguousWidth : uint8_t {
+		Narrow,
+		Wide
+	};
+
+	// The number of terminal columns x takes up on its own: 0 for marks,
+	// format and control characters, 2 for wide and fullwidth ones.
+	constexpr uint8_t get_display_width(
+			codepoint_t x,
+			AmbiguousWidth ambiguous = AmbiguousWidth::Narrow);
+
+	// what the width table stores for East_Asian_Width=A
+	constexpr uint8_t DISPLAY_WIDTH_AMBIGUOUS = 3;
+
+	// the width of a single grapheme cluster
+	size_t get_cluster_display_width(
+			const codepoint_t* s, size_t len,
+			AmbiguousWidth ambiguous = AmbiguousWidth::Narrow);
+
+	size_t get_display_width(
+			const codepoint_t* s, size_t len,
+			AmbiguousWidth ambiguous = AmbiguousWidth::Narrow);
+
+	inline size_t get_display_width(
+			const string_t& s,
+			AmbiguousWidth ambiguous = AmbiguousWidth::Narrow) {
+		return get_display_width(s.data(), s.size(), ambiguous);
+	}
 
 
 	/***** Scripts *****/
@@ -783,7 +819,60 @@ namespace Unicode {
 		Vithkuqi,
 	};
 
-	Script get_script(codepoint_t x);
+	constexpr Script get_script(codepoint_t x);
+
+
+	/***** Bulk lookups *****/
+
+	// These look up a whole span at once, out must have room for len values.
+	// They are much faster than calling the single codepoint versions in a
+	// loop, since neighbouring codepoints usually share a table chunk.
+	void get_general_category (const codepoint_t* s, size_t len, GeneralCategory* out);
+	void get_simple_properties(const codepoint_t* s, size_t len, uint64_t* out);
+	void get_east_asian_width (const codepoint_t* s, size_t len, EastAsianWidth* out);
+	void get_line_break       (const codepoint_t* s, size_t len, LineBreak* out);
+	void get_script           (const codepoint_t* s, size_t len, Script* out);
+	void get_bidi_class       (const codepoint_t* s, size_t len, BidiClass* out);
+
+	// the number of uint64_t needed for a bitmask with one bit per codepoint
+	constexpr size_t get_match_mask_len(size_t len) {
+		return (len + 63) / 64;
+	}
+
+	constexpr uint32_t general_category_mask(GeneralCategory x) {
+		return uint32_t(1) << static_cast<uint8_t>(x);
+	}
+
+	// Bit (i % 64) of out[i / 64] is set if s[i] has any of the given
+	// SimplePropertyFlags. out must have room for get_match_mask_len(len).
+	void match_simple_properties(
+			const codepoint_t* s, size_t len,
+			uint64_t flags,
+			uint64_t* out);
+
+	// the same, for a set of general_category_mask() values or'd together
+	void match_general_categories(
+			const codepoint_t* s, size_t len,
+			uint32_t category_mask,
+			uint64_t* out);
+
+
+	/***** Lookup tables *****/
+
+	// The full two-stage tables from the auto_*.cpp files, which the
+	// functions above only fall back to above LATIN1_MAX
+	namespace trie {
+		GeneralCategory get_general_category   (codepoint_t x);
+		uint64_t        get_simple_properties  (codepoint_t x);
+		EastAsianWidth  get_east_asian_width   (codepoint_t x);
+		LineBreak       get_line_break         (codepoint_t x);
+		Script          get_script             (codepoint_t x);
+		BidiClass       get_bidi_class         (codepoint_t x);
+		uint8_t         get_display_width_class(codepoint_t x);
+	}
+
+	// every flag of PropList.txt and emoji-data.txt, see SimplePropertyFlags
+	constexpr uint64_t get_simple_properties(codepoint_t x);
 
 
 	/***** data types to strings *****/
@@ -792,11 +881,13 @@ namespace Unicode {
 	const char* to_string(HangulSyllableType x);
 	const char* to_string(IndicSyllabicCategory x);
 	const char* to_string(EastAsianWidth x);
+	const char* to_string(AmbiguousWidth x);
 	const char* to_string(GraphemeClusterBreak x);
 	const char* to_string(WordBreak x);
 	const char* to_string(LineBreak x);
 	const char* to_string(SentenceBreak x);
 	const char* to_string(Script x);
+	const char* to_string(BidiClass x);
 
 	inline std::string to_string(codepoint_t x) {
 		static const char HEX_CHARS[] = {
@@ -824,4 +915,6 @@ namespace Unicode {
 	}
 };
 
+#include "auto_latin1.hpp"
+
 #endif
@@ -0,0 +1,122 @@
+#ifndef INCLUDED_UNICODE_BIDI_HPP
+#define INCLUDED_UNICODE_BIDI_HPP
+
+#include "unicode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Unicode {
+
+	// The Unicode Bidirectional Algorithm, UAX #9
+	// https://www.unicode.org/reports/tr9/
+
+	/***** Brackets and mirroring *****/
+
+	enum class BidiBracketType : uint8_t {
+		None,
+		Open,
+		Close
+	};
+
+	BidiBracketType get_bidi_bracket_type(codepoint_t x);
+
+	// the other bracket of the pair, or x if it is not a bracket
+	codepoint_t get_bidi_paired_bracket(codepoint_t x);
+
+	// The same for both brackets of a pair, and for their canonical
+	// equivalents, so U+2329 and U+3009 have the same id. 0 if x is not
+	// a bracket.
+	codepoint_t get_bidi_bracket_pair_id(codepoint_t x);
+
+	// the glyph to show for x at an odd level (e.g. ')' for '('), or x
+	codepoint_t get_bidi_mirroring_glyph(codepoint_t x);
+
+
+	/***** Resolving levels *****/
+
+	using bidi_level_t = uint8_t;
+
+	// the deepest embedding level, see BD2
+	constexpr bidi_level_t MAX_BIDI_DEPTH = 125;
+
+	enum class BidiDirection : uint8_t {
+		LTR,
+		RTL,
+		Auto // from the first strong character, rules P2 and P3
+	};
+
+	// Rules P2 and P3: 1 if the first strong character outside of
+	// isolates is R or AL, 0 otherwise.
+	bidi_level_t get_paragraph_level(const codepoint_t* s, size_t len);
+
+	// True if s has anything that could put a character at a level
+	// other than 0 in an LTR paragraph: R, AL, AN, or explicit
+	// formatting. This is one bulk scan of the Bidi_Class table.
+	bool needs_bidi(const codepoint_t* s, size_t len);
+
+	// The resolved embedding levels of one paragraph. Paragraph
+	// separators in the middle of s end every embedding, like rule X8,
+	// but s is still treated as one paragraph.
+	//
+	// Text that needs no bidi processing at all (see needs_bidi) is
+	// recognized with a single table scan and stores no levels, so
+	// keeping one of these around per line of mostly LTR text is cheap.
+	class BidiParagraph {
+		public:
+			// an empty LTR paragraph
+			BidiParagraph() {}
+
+			BidiParagraph(
+					const codepoint_t* s, size_t len,
+					BidiDirection direction = BidiDirection::Auto);
+
+			explicit BidiParagraph(
+					const string_t& s,
+					BidiDirection direction = BidiDirection::Auto)
+				: BidiParagraph(s.data(), s.size(), direction) {}
+
+			bidi_level_t get_paragraph_level() const { return paragraph_level; }
+
+			// the number of codepoints
+			size_t size() const { return len; }
+
+			// True if s needed no bidi processing (see needs_bidi). Every
+			// level is 0 then, and the visual order is the logical one.
+			bool is_ltr() const { return levels.empty(); }
+
+			// The level of each codepoint, after rule L1 for the paragraph
+			// as a single line. Characters removed by rule X9 get the level
+			// of the character before them.
+			bidi_level_t get_level(size_t i) const {
+				return levels.empty() ? 0 : levels[i];
+			}
+
+			// Rule L2 for the line s[begin..end): out[i] is the logical
+			// index of the codepoint shown at visual position i. out must
+			// have room for end - begin.
+			void get_visual_order(size_t begin, size_t end, size_t* out) const;
+
+		private:
+			size_t len = 0;
+			bidi_level_t paragraph_level = 0;
+
+			// empty if is_ltr()
+			std::vector<bidi_level_t> levels;
+	};
+
+	// Shows s, a paragraph of a single line, in visual order: reordered,
+	// with the characters at odd levels mirrored (rule L4), and without the
+	// explicit formatting characters (LRE to PDI), which terminals should
+	// not see. Grapheme clusters at odd levels keep their logical order, so
+	// combining marks stay after their base (rule L3).
+	string_t reorder_visually(const string_t& s, const BidiParagraph& paragraph);
+
+	string_t reorder_visually(
+			const string_t& s,
+			BidiDirection direction = BidiDirection::Auto);
+
+}
+
+#endif
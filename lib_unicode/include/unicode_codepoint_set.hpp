@@ -0,0 +1,123 @@
+#ifndef INCLUDED_UNICODE_CODEPOINT_SET_HPP
+#define INCLUDED_UNICODE_CODEPOINT_SET_HPP
+
+#include "unicode.hpp"
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Unicode {
+
+	// A set of codepoints, stored as an inversion list: a sorted list of
+	// boundaries where membership flips, starting outside the set. So
+	// { 'a', 'z' + 1, 0x100, 0x180 } is a-z and U+0100..U+017F.
+	//
+	// The BMP is also kept as a bitmap, so that membership there is O(1),
+	// and O(log n) in the number of ranges elsewhere. Union, intersection
+	// and complement work on the inversion lists, in O(n). Sets are meant
+	// to be built once and then queried a lot, since every change rebuilds
+	// the bitmap.
+	class CodepointSet {
+		public:
+			// the codepoints covered by the bitmap
+			static constexpr codepoint_t BITMAP_MAX = 0xFFFF;
+
+			// the empty set
+			CodepointSet();
+
+			CodepointSet(std::initializer_list<codepoint_t> codepoints);
+
+			// first to last inclusive
+			static CodepointSet from_range(codepoint_t first, codepoint_t last);
+
+			// every codepoint for which pred(x) is true
+			template <typename Pred>
+			static CodepointSet from_predicate(Pred pred);
+
+			// everything up to MAX_CODEPOINT
+			static CodepointSet all();
+
+			bool contains(codepoint_t x) const {
+				if (x <= BITMAP_MAX) {
+					return (bitmap[x / 64] >> (x % 64)) & 1;
+				}
+				return contains_above_bitmap(x);
+			}
+
+			// Sets bit i % 64 of out[i / 64] if s[i] is in the set, like
+			// match_simple_properties. out must have room for
+			// get_match_mask_len(len).
+			void match(const codepoint_t* s, size_t len, uint64_t* out) const;
+
+			bool empty() const { return inversion_list.empty(); }
+
+			// the number of codepoints
+			size_t size() const;
+
+			// the number of ranges
+			size_t get_range_count() const { return inversion_list.size() / 2; }
+
+			const std::vector<codepoint_t>& get_inversion_list() const {
+				return inversion_list;
+			}
+
+			void add(codepoint_t x);
+			void add_range(codepoint_t first, codepoint_t last);
+
+			CodepointSet operator|(const CodepointSet& other) const;
+			CodepointSet operator&(const CodepointSet& other) const;
+			CodepointSet operator-(const CodepointSet& other) const;
+
+			// the complement within 0 to MAX_CODEPOINT
+			CodepointSet operator~() const;
+
+			CodepointSet& operator|=(const CodepointSet& other);
+			CodepointSet& operator&=(const CodepointSet& other);
+			CodepointSet& operator-=(const CodepointSet& other);
+
+			bool operator==(const CodepointSet& other) const {
+				return inversion_list == other.inversion_list;
+			}
+			bool operator!=(const CodepointSet& other) const {
+				return !(*this == other);
+			}
+
+		private:
+			explicit CodepointSet(std::vector<codepoint_t>&& inversion_list);
+
+			bool contains_above_bitmap(codepoint_t x) const;
+
+			void build_bitmap();
+
+			std::vector<codepoint_t> inversion_list;
+			std::array<uint64_t, (BITMAP_MAX + 1) / 64> bitmap;
+	};
+
+	// e.g. "[U+0041..U+005A U+0061..U+007A]"
+	std::string to_string(const CodepointSet& x);
+
+	template <typename Pred>
+	CodepointSet CodepointSet::from_predicate(Pred pred) {
+		std::vector<codepoint_t> ret;
+		bool inside = false;
+
+		for (codepoint_t x = 0; x <= MAX_CODEPOINT; x++) {
+			if (pred(x) != inside) {
+				ret.push_back(x);
+				inside = !inside;
+			}
+		}
+
+		if (inside) {
+			ret.push_back(MAX_CODEPOINT + 1);
+		}
+
+		return CodepointSet(std::move(ret));
+	}
+
+}
+
+#endif
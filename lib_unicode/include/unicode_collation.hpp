@@ -0,0 +1,79 @@
+#ifndef INCLUDED_UNICODE_COLLATION_HPP
+#define INCLUDED_UNICODE_COLLATION_HPP
+
+#include "unicode.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// UTS #10, https://www.unicode.org/reports/tr10/
+// This uses the untailored DUCET, with variable weighting set to
+// non-ignorable.
+
+namespace Unicode {
+
+	struct CollationElement {
+		uint16_t primary;
+		uint16_t secondary;
+		uint8_t tertiary;
+
+		bool operator==(const CollationElement& other) const {
+			return primary == other.primary
+				&& secondary == other.secondary
+				&& tertiary == other.tertiary;
+		}
+	};
+
+	enum class CollationStrength : uint8_t {
+		Primary   = 1, // base letters only
+		Secondary = 2, // and accents
+		Tertiary  = 3  // and case
+	};
+
+	// A sort key is a byte string, so two of them can be compared with
+	// memcmp, or with std::string's operator<, which does the same thing.
+	using sort_key_t = std::string;
+
+	// the collation elements of s, after converting it to NFD
+	std::vector<CollationElement> get_collation_elements(const codepoint_t* s, size_t len);
+
+	sort_key_t get_sort_key(
+			const codepoint_t* s, size_t len,
+			CollationStrength strength = CollationStrength::Tertiary);
+
+	inline sort_key_t get_sort_key(
+			const string_t& s,
+			CollationStrength strength = CollationStrength::Tertiary) {
+		return get_sort_key(s.data(), s.size(), strength);
+	}
+
+	// <0, 0 or >0, like strcmp. If strings are compared more than once,
+	// keep their sort keys instead.
+	int collate(
+			const string_t& a,
+			const string_t& b,
+			CollationStrength strength = CollationStrength::Tertiary);
+
+
+	/***** DUCET lookups *****/
+
+	// the most elements one codepoint or contraction maps to, see U+FDFA
+	constexpr size_t MAX_COLLATION_ELEMENTS = 18;
+
+	// if x is the first codepoint of a contraction in the DUCET
+	bool starts_contraction(codepoint_t x);
+
+	// Looks up one codepoint, or a contraction of two or three, and writes
+	// its elements to out, which must have room for MAX_COLLATION_ELEMENTS.
+	// Returns false if the DUCET has no entry for seq.
+	bool get_ducet_elements(
+			const codepoint_t* seq, size_t len,
+			CollationElement* out, size_t* out_len);
+
+	// the two elements for a codepoint that is not in the DUCET
+	void get_implicit_collation_elements(codepoint_t x, CollationElement* out);
+
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef INCLUDED_UNICODE_CONFUSABLES_HPP
+#define INCLUDED_UNICODE_CONFUSABLES_HPP
+
+#include "unicode.hpp"
+
+#include <cstddef>
+
+// UTS #39, https://www.unicode.org/reports/tr39/
+
+namespace Unicode {
+
+	// Confusable detection: two strings that look alike, such as "paypal"
+	// spelled with U+0430 CYRILLIC SMALL LETTER A and the ASCII one, have
+	// the same skeleton. Skeletons are only for comparing, and are not
+	// meant to be displayed.
+
+	// the longest prototype, see U+FDFA
+	constexpr size_t MAX_CONFUSABLE_PROTOTYPE_LEN = 18;
+
+	// Writes the prototype of x from confusables.txt to out, which must have
+	// room for MAX_CONFUSABLE_PROTOTYPE_LEN codepoints, and returns how many
+	// were written. Codepoints that are not confusable are their own
+	// prototype.
+	size_t get_confusable_prototype(codepoint_t x, codepoint_t* out);
+
+	// The skeleton of s, which is its NFD without default ignorable
+	// codepoints, with each codepoint replaced by its prototype, and
+	// normalized to NFD again.
+	string_t get_skeleton(const string_t& s);
+
+	// whether a and b have the same skeleton
+	bool are_confusable(const string_t& a, const string_t& b);
+
+}
+
+#endif
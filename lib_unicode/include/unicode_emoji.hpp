@@ -0,0 +1,39 @@
+#ifndef INCLUDED_UNICODE_EMOJI_HPP
+#define INCLUDED_UNICODE_EMOJI_HPP
+
+#include "unicode.hpp"
+
+#include <cstddef>
+
+// UTS #51, https://www.unicode.org/reports/tr51/
+
+namespace Unicode {
+
+	// Returns the length of the longest RGI emoji sequence that s starts
+	// with, or 0 if it does not start with one. These are the sequences
+	// from emoji-sequences.txt and emoji-zwj-sequences.txt: emoji with
+	// emoji presentation, keycaps, flags, tag sequences (e.g. the flag of
+	// England), skin tone modifier sequences and ZWJ sequences. Each of
+	// them is drawn as a single two column glyph.
+	//
+	// This is a single pass over s that stops as soon as no sequence can
+	// match any more, so it only looks at as many codepoints as the
+	// longest sequence starting with them.
+	size_t match_emoji_sequence(const codepoint_t* s, size_t len);
+
+	inline size_t match_emoji_sequence(const string_t& s) {
+		return match_emoji_sequence(s.data(), s.size());
+	}
+
+	// whether all of s is one RGI emoji sequence
+	inline bool is_emoji_sequence(const codepoint_t* s, size_t len) {
+		return len > 0 && match_emoji_sequence(s, len) == len;
+	}
+
+	inline bool is_emoji_sequence(const string_t& s) {
+		return is_emoji_sequence(s.data(), s.size());
+	}
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef INCLUDED_UNICODE_NAMES_HPP
+#define INCLUDED_UNICODE_NAMES_HPP
+
+#include "unicode.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace Unicode {
+
+	// The Name property, e.g. "LATIN SMALL LETTER A" for U+0061, including
+	// the algorithmically derived names of CJK ideographs and Hangul
+	// syllables. Controls, private use characters, surrogates and
+	// unassigned codepoints have no name.
+
+	// the longest name, checked by the codegen
+	constexpr size_t MAX_NAME_LEN = 128;
+
+	// Writes the name of x to out, which must have room for MAX_NAME_LEN
+	// chars, and returns its length, or 0 if x has no name. out is not
+	// null terminated.
+	size_t get_name(codepoint_t x, char* out);
+
+	// the name of x, or "" if it has none
+	std::string get_name(codepoint_t x);
+
+	// e.g. "U+0061 LATIN SMALL LETTER A", for debug output
+	std::string to_string_with_name(codepoint_t x);
+
+	// Looks up a codepoint by its name, ignoring ASCII case. Returns false
+	// if there is no such name.
+	bool find_by_name(const std::string& name, codepoint_t* out);
+
+	// Writes the codepoints whose names start with prefix (ignoring ASCII
+	// case) to out in the order of their names, at most out_len of them,
+	// and returns how many there are, like snprintf. Only explicit names
+	// are searched, not the algorithmically derived ones.
+	size_t find_by_name_prefix(const std::string& prefix, codepoint_t* out, size_t out_len);
+
+	// The generated tables behind these, see gen_names.py. Names are
+	// numbered in codepoint order, from 0 to size() - 1.
+	namespace name_table {
+		// a range of codepoints named prefix + their hex value
+		struct Range {
+			codepoint_t first;
+			codepoint_t last;
+			const char* prefix;
+		};
+
+		// the number of explicit names
+		size_t size();
+
+		// the index of the name of x, or size() if it has no explicit one
+		size_t find(codepoint_t x);
+
+		codepoint_t get_codepoint(size_t i);
+
+		// like Unicode::get_name
+		size_t get_name(size_t i, char* out);
+
+		// the hash table, where each slot is an index or size() if empty
+		size_t get_hash_slot_count();
+		size_t get_hash_slot(size_t slot);
+
+		// the index of the name at rank in the sorted names
+		size_t get_by_name(size_t rank);
+
+		size_t get_range_count();
+		const Range& get_range(size_t i);
+	}
+
+}
+
+#endif
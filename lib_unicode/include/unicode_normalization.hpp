@@ -0,0 +1,71 @@
+#ifndef INCLUDED_UNICODE_NORMALIZATION_HPP
+#define INCLUDED_UNICODE_NORMALIZATION_HPP
+
+#include "unicode.hpp"
+
+#include <cstdint>
+#include <string>
+
+// UAX #15, https://www.unicode.org/reports/tr15/
+
+namespace Unicode {
+
+	enum class NormalizationForm : uint8_t {
+		NFC,
+		NFD,
+		NFKC,
+		NFKD
+	};
+
+	enum class QuickCheck : uint8_t {
+		Yes,
+		No,
+		Maybe
+	};
+
+	// NFD_QC, NFC_QC, NFKD_QC and NFKC_QC from DerivedNormalizationProps.txt
+	QuickCheck get_quick_check(codepoint_t x, NormalizationForm form);
+
+	// the longest decomposition, see U+FDFA
+	constexpr size_t MAX_DECOMPOSITION_LEN = 18;
+
+	// Writes the full (recursive) canonical or compatibility decomposition
+	// of x into out, which must have room for MAX_DECOMPOSITION_LEN
+	// codepoints. Hangul syllables are decomposed algorithmically. Returns
+	// how many codepoints were written, or 0 if x does not decompose.
+	size_t get_decomposition(codepoint_t x, bool compat, codepoint_t* out);
+
+	// returns the primary composite of the pair, or 0 if there is none
+	codepoint_t get_composition(codepoint_t first, codepoint_t second);
+
+	// below these, every codepoint is Yes and has a combining class of 0
+	inline codepoint_t get_quick_check_threshold(NormalizationForm form) {
+		switch (form) {
+			case NormalizationForm::NFC:  return 0x0300;
+			case NormalizationForm::NFD:  return 0x00C0;
+			case NormalizationForm::NFKC: return 0x00A0;
+			case NormalizationForm::NFKD: return 0x00A0;
+		}
+		return 0;
+	}
+
+	// a single scan that never allocates
+	QuickCheck quick_check(const codepoint_t* s, size_t len, NormalizationForm form);
+
+	inline QuickCheck quick_check(const string_t& s, NormalizationForm form) {
+		return quick_check(s.data(), s.size(), form);
+	}
+
+	bool is_normalized(const string_t& s, NormalizationForm form);
+
+	string_t normalize(const string_t& s, NormalizationForm form);
+
+	// returns false (and does not allocate) if s was already normalized
+	bool normalize_in_place(string_t& s, NormalizationForm form);
+
+	const char* to_string(NormalizationForm x);
+	const char* to_string(QuickCheck x);
+
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef INCLUDED_UNICODE_PROPERTY_DB_HPP
+#define INCLUDED_UNICODE_PROPERTY_DB_HPP
+
+#include "unicode.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Unicode {
+
+	// A binary property database written by codegen/gen_property_db.py and
+	// mapped read-only into memory, so a new Unicode version only needs a
+	// new file rather than a rebuild, and every process using the same file
+	// shares its pages. The compiled-in tables are unaffected by this.
+	//
+	// The file starts with a Header, followed by table_count TableEntry
+	// records and then each table's chunk index and chunk data.
+	class PropertyDatabase {
+		public:
+			static constexpr char MAGIC[8] = { 'U', 'N', 'I', 'P', 'R', 'D', 'B', '\0' };
+			static constexpr uint32_t FORMAT_VERSION = 1;
+
+			enum class Table : uint32_t {
+				GeneralCategory,
+				SimpleProperties,
+				EastAsianWidth,
+				LineBreak,
+				Script,
+				DisplayWidth,
+
+				COUNT
+			};
+
+			struct Header {
+				char magic[8];
+				uint32_t format_version;
+				uint32_t table_count;
+				char unicode_version[16];
+				uint64_t body_size; // everything after the header
+				uint64_t checksum;  // FNV-1a of the body
+			};
+
+			struct TableEntry {
+				uint32_t id;
+				uint32_t elem_size;
+				uint32_t chunk_len;
+				uint32_t chunk_count;
+				uint64_t out_of_bounds_value;
+				uint64_t index_offset;
+				uint64_t data_offset;
+			};
+
+			// Throws std::runtime_error if the file cannot be mapped, or if
+			// it is not a valid database. Checking the checksum reads the
+			// whole file once.
+			static std::unique_ptr<PropertyDatabase> open(
+					const std::string& path,
+					bool verify_checksum = true);
+
+			~PropertyDatabase();
+
+			PropertyDatabase(const PropertyDatabase&) = delete;
+			PropertyDatabase& operator=(const PropertyDatabase&) = delete;
+
+			// e.g. "15.1.0", or "unknown"
+			std::string get_unicode_version() const;
+
+			GeneralCategory get_general_category (codepoint_t x) const;
+			uint64_t        get_simple_properties(codepoint_t x) const;
+			EastAsianWidth  get_east_asian_width (codepoint_t x) const;
+			LineBreak       get_line_break       (codepoint_t x) const;
+			Script          get_script           (codepoint_t x) const;
+
+			uint8_t get_display_width(
+					codepoint_t x,
+					AmbiguousWidth ambiguous = AmbiguousWidth::Narrow) const;
+
+		private:
+			struct MappedTable {
+				const uint32_t* index = nullptr;
+				const uint8_t* data = nullptr;
+				uint32_t elem_size = 0;
+				uint32_t chunk_len = 0;
+				uint32_t chunk_count = 0;
+				uint64_t out_of_bounds_value = 0;
+			};
+
+			PropertyDatabase(const void* map, size_t map_len);
+
+			uint64_t lookup(Table table, codepoint_t x) const;
+
+			const void* map;
+			const size_t map_len;
+			MappedTable tables[static_cast<size_t>(Table::COUNT)];
+	};
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef INCLUDED_UNICODE_SCRIPT_RUNS_HPP
+#define INCLUDED_UNICODE_SCRIPT_RUNS_HPP
+
+#include "unicode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Unicode {
+
+	// the number of Script values, the last one being Vithkuqi
+	constexpr size_t SCRIPT_COUNT = static_cast<size_t>(Script::Vithkuqi) + 1;
+
+	// A set of scripts, as a bitset. This is a plain aggregate so that the
+	// generated tables can be initialized at compile time.
+	struct ScriptSet {
+		static constexpr size_t WORDS = (SCRIPT_COUNT + 63) / 64;
+
+		uint64_t words[WORDS];
+
+		static constexpr ScriptSet none() {
+			return ScriptSet{};
+		}
+
+		static constexpr ScriptSet of(Script x) {
+			ScriptSet ret{};
+			ret.words[static_cast<size_t>(x) / 64] = uint64_t(1) << (static_cast<size_t>(x) % 64);
+			return ret;
+		}
+
+		constexpr bool contains(Script x) const {
+			return (words[static_cast<size_t>(x) / 64] >> (static_cast<size_t>(x) % 64)) & 1;
+		}
+
+		constexpr bool empty() const {
+			for (size_t i = 0; i < WORDS; i++) {
+				if (words[i] != 0) return false;
+			}
+			return true;
+		}
+
+		// the script with the lowest value in the set, or Unknown if empty
+		Script first() const;
+
+		// the number of scripts in the set
+		size_t size() const;
+
+		constexpr ScriptSet operator&(const ScriptSet& other) const {
+			ScriptSet ret{};
+			for (size_t i = 0; i < WORDS; i++) {
+				ret.words[i] = words[i] & other.words[i];
+			}
+			return ret;
+		}
+
+		constexpr ScriptSet operator|(const ScriptSet& other) const {
+			ScriptSet ret{};
+			for (size_t i = 0; i < WORDS; i++) {
+				ret.words[i] = words[i] | other.words[i];
+			}
+			return ret;
+		}
+
+		constexpr bool operator==(const ScriptSet& other) const {
+			for (size_t i = 0; i < WORDS; i++) {
+				if (words[i] != other.words[i]) return false;
+			}
+			return true;
+		}
+
+		constexpr bool operator!=(const ScriptSet& other) const {
+			return !(*this == other);
+		}
+	};
+
+	// The Script_Extensions property: the scripts a codepoint is used
+	// with. For most codepoints this is just { get_script(x) }, but e.g.
+	// U+0640 ARABIC TATWEEL is Common and used with Arabic, Syriac, and
+	// a few others.
+	ScriptSet get_script_extensions(codepoint_t x);
+
+	// the same for a whole span, out must have room for len sets
+	void get_script_extensions(const codepoint_t* s, size_t len, ScriptSet* out);
+
+	// A maximal span of s[begin..end) that can be written in one script.
+	struct ScriptRun {
+		size_t begin;
+		size_t end;
+		Script script;
+	};
+
+	// Splits s into script runs (UAX #24). Codepoints that are Common or
+	// Inherited without any Script_Extensions, like spaces, digits and
+	// combining marks, join the run they are in, so a leading one joins the
+	// following run and the rest the preceding one. Codepoints with
+	// Script_Extensions narrow the run down to the scripts they share with
+	// it, and start a new run when there are none left. A run that is all
+	// Common or Inherited is Common.
+	//
+	// This is a single pass over s, and allocates nothing. At most out_len
+	// runs are written to out, and the number of runs in s is returned,
+	// like snprintf. A string is never split into more than len runs.
+	size_t get_script_runs(
+			const codepoint_t* s, size_t len,
+			ScriptRun* out, size_t out_len);
+
+}
+
+#endif
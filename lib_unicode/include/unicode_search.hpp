@@ -0,0 +1,39 @@
+#ifndef INCLUDED_UNICODE_SEARCH_HPP
+#define INCLUDED_UNICODE_SEARCH_HPP
+
+#include "unicode.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace Unicode {
+
+	// Search folding makes text comparable the way people type it: the
+	// compatibility decomposition is case folded, nonspacing marks are
+	// dropped, and a few letters and punctuation marks without a
+	// decomposition are substituted (e.g. U+00E6 becomes "ae", U+2019 "'").
+	// So "Résumé" and "resume" fold to the same thing. This is
+	// meant for matching, and loses far too much for display.
+
+	// the most codepoints one codepoint folds to, see U+FDFA
+	constexpr size_t MAX_SEARCH_FOLDING_LEN = 18;
+
+	// Writes the folding of x to out, which must have room for
+	// MAX_SEARCH_FOLDING_LEN codepoints, and returns how many were written.
+	// This may be 0, for marks that fold to nothing.
+	size_t get_search_folding(codepoint_t x, codepoint_t* out);
+
+	// Folds s into out, writing at most out_len codepoints, and returns the
+	// length of the whole folding, like snprintf. If that is more than
+	// out_len, the folding was cut short. The folded text is never longer
+	// than len * MAX_SEARCH_FOLDING_LEN, and is usually no longer than s.
+	// ASCII is only lowercased, and is handled a block at a time.
+	size_t fold_for_search(
+			const codepoint_t* s, size_t len,
+			codepoint_t* out, size_t out_len);
+
+	string_t fold_for_search(const string_t& s);
+
+}
+
+#endif
@@ -0,0 +1,715 @@
+#include "unicode_bidi.hpp"
+
+#include <algorithm>
+
+using Unicode::codepoint_t;
+using Unicode::string_t;
+using Unicode::BidiClass;
+using Unicode::BidiBracketType;
+using Unicode::BidiDirection;
+using Unicode::BidiParagraph;
+using Unicode::bidi_level_t;
+
+namespace {
+	using X = BidiClass;
+
+	// codepoints per bulk lookup
+	constexpr size_t BLOCK_LEN = 64;
+
+	// for codepoints that have no matching isolate initiator or PDI
+	constexpr size_t NONE = SIZE_MAX;
+
+	// the deepest nesting of brackets N0 looks at, see BD16
+	constexpr size_t MAX_BRACKET_DEPTH = 63;
+
+	constexpr uint32_t mask(BidiClass x) {
+		return uint32_t(1) << static_cast<uint8_t>(x);
+	}
+
+	constexpr uint32_t EXPLICIT_FORMATTING =
+		mask(X::LRE) | mask(X::LRO) | mask(X::RLE) | mask(X::RLO) | mask(X::PDF)
+		| mask(X::LRI) | mask(X::RLI) | mask(X::FSI) | mask(X::PDI);
+
+	// anything that can make a level other than 0 in an LTR paragraph
+	constexpr uint32_t NEEDS_BIDI =
+		mask(X::R) | mask(X::AL) | mask(X::AN) | EXPLICIT_FORMATTING;
+
+	constexpr uint32_t ISOLATE_INITIATORS = mask(X::LRI) | mask(X::RLI) | mask(X::FSI);
+
+	// ignored from rule X9 on
+	constexpr uint32_t REMOVED_BY_X9 =
+		mask(X::LRE) | mask(X::LRO) | mask(X::RLE) | mask(X::RLO) | mask(X::PDF) | mask(X::BN);
+
+	// neutrals and isolate formatting characters, for N1 and N2
+	constexpr uint32_t NEUTRALS =
+		mask(X::B) | mask(X::S) | mask(X::WS) | mask(X::ON)
+		| mask(X::LRI) | mask(X::RLI) | mask(X::FSI) | mask(X::PDI);
+
+	// what L1 moves to the paragraph level before separators and at the end
+	constexpr uint32_t TRAILING_WHITESPACE =
+		mask(X::WS) | mask(X::LRI) | mask(X::RLI) | mask(X::FSI) | mask(X::PDI)
+		| REMOVED_BY_X9;
+
+	constexpr bool is(BidiClass x, uint32_t m) {
+		return (mask(x) & m) != 0;
+	}
+
+	constexpr bidi_level_t direction_of(bidi_level_t level) {
+		return level & 1;
+	}
+
+	constexpr BidiClass class_of(bidi_level_t level) {
+		return (level & 1) ? X::R : X::L;
+	}
+
+	// the least odd or even level above level
+	constexpr bidi_level_t next_level(bidi_level_t level, bool rtl) {
+		return rtl ? (level + 1) | 1 : (level + 2) & ~1;
+	}
+
+	// Numbers count as R in N0, N1 and N2. Everything else is neutral here.
+	constexpr BidiClass strong_direction(BidiClass x) {
+		return x == X::L ? X::L
+			: (x == X::R || x == X::AL || x == X::EN || x == X::AN) ? X::R
+			: X::ON;
+	}
+
+	// Rules P2 and P3 over types[begin..end): the direction of the first
+	// strong type outside of isolates, 0 if there is none. This stops at a
+	// paragraph separator.
+	class FirstStrong {
+		public:
+			// false once the direction is known
+			bool feed(BidiClass x) {
+				if (is(x, ISOLATE_INITIATORS)) {
+					depth++;
+				} else if (x == X::PDI) {
+					if (depth > 0) depth--;
+				} else if (x == X::B) {
+					return false;
+				} else if (depth == 0 && (x == X::L || x == X::R || x == X::AL)) {
+					level = x == X::L ? 0 : 1;
+					return false;
+				}
+				return true;
+			}
+
+			bidi_level_t level = 0;
+
+		private:
+			size_t depth = 0;
+	};
+
+	bidi_level_t get_first_strong(const BidiClass* types, size_t begin, size_t end) {
+		FirstStrong first_strong;
+		for (size_t i = begin; i < end && first_strong.feed(types[i]); i++);
+		return first_strong.level;
+	}
+
+	struct DirectionalStatus {
+		bidi_level_t level;
+		BidiClass override_status; // ON if none
+		bool isolate;
+	};
+
+	// The state of resolving one paragraph, rules X1 to I2
+	class Resolver {
+		public:
+			Resolver(const codepoint_t* s, size_t len, bidi_level_t paragraph_level, std::vector<bidi_level_t>& levels)
+				: s(s), len(len), paragraph_level(paragraph_level), levels(levels),
+				initial(len), types(len),
+				matching_pdi(len, NONE), matching_initiator(len, NONE) {
+
+				Unicode::get_bidi_class(s, len, initial.data());
+				types = initial;
+				levels.assign(len, paragraph_level);
+			}
+
+			static bidi_level_t get_paragraph_level(const codepoint_t* s, size_t len) {
+				FirstStrong first_strong;
+				BidiClass types[BLOCK_LEN];
+				for (size_t i = 0; i < len; i += BLOCK_LEN) {
+					const size_t n = std::min(len - i, BLOCK_LEN);
+					Unicode::get_bidi_class(s + i, n, types);
+					for (size_t j = 0; j < n; j++) {
+						if (!first_strong.feed(types[j])) return first_strong.level;
+					}
+				}
+				return first_strong.level;
+			}
+
+			void resolve() {
+				match_isolates();
+				resolve_explicit_levels();
+				resolve_isolating_run_sequences();
+				assign_removed_levels();
+				reset_whitespace_levels();
+			}
+
+		private:
+			const codepoint_t* s;
+			const size_t len;
+			const bidi_level_t paragraph_level;
+			std::vector<bidi_level_t>& levels;
+
+			// the Bidi_Class of each codepoint, and the type it is resolved to
+			std::vector<BidiClass> initial;
+			std::vector<BidiClass> types;
+
+			// BD9
+			std::vector<size_t> matching_pdi;
+			std::vector<size_t> matching_initiator;
+
+			bool is_removed(size_t i) const {
+				return is(initial[i], REMOVED_BY_X9);
+			}
+
+			void match_isolates() {
+				std::vector<size_t> open;
+				for (size_t i = 0; i < len; i++) {
+					if (is(initial[i], ISOLATE_INITIATORS)) {
+						open.push_back(i);
+					} else if (initial[i] == X::PDI) {
+						if (!open.empty()) {
+							matching_pdi[open.back()] = i;
+							matching_initiator[i] = open.back();
+							open.pop_back();
+						}
+					} else if (initial[i] == X::B) {
+						open.clear();
+					}
+				}
+			}
+
+			// X1 to X8
+			void resolve_explicit_levels() {
+				DirectionalStatus stack[Unicode::MAX_BIDI_DEPTH + 2];
+				size_t depth = 0;
+				stack[depth++] = { paragraph_level, X::ON, false };
+
+				size_t overflow_isolates = 0;
+				size_t overflow_embeddings = 0;
+				size_t valid_isolates = 0;
+
+				for (size_t i = 0; i < len; i++) {
+					const BidiClass t = initial[i];
+
+					switch (t) {
+						case X::RLE:
+						case X::LRE:
+						case X::RLO:
+						case X::LRO: {
+							// X2 to X5
+							const bidi_level_t level = next_level(
+									stack[depth - 1].level,
+									t == X::RLE || t == X::RLO);
+
+							levels[i] = stack[depth - 1].level;
+
+							if (level <= Unicode::MAX_BIDI_DEPTH
+									&& overflow_isolates == 0
+									&& overflow_embeddings == 0) {
+								const BidiClass override_status =
+									t == X::RLO ? X::R : t == X::LRO ? X::L : X::ON;
+								stack[depth++] = { level, override_status, false };
+							} else if (overflow_isolates == 0) {
+								overflow_embeddings++;
+							}
+							break;
+						}
+
+						case X::RLI:
+						case X::LRI:
+						case X::FSI: {
+							// X5a to X5c
+							levels[i] = stack[depth - 1].level;
+							if (stack[depth - 1].override_status != X::ON) {
+								types[i] = stack[depth - 1].override_status;
+							}
+
+							bool rtl = t == X::RLI;
+							if (t == X::FSI) {
+								const size_t end = matching_pdi[i] == NONE ? len : matching_pdi[i];
+								rtl = get_first_strong(initial.data(), i + 1, end) == 1;
+							}
+
+							const bidi_level_t level = next_level(stack[depth - 1].level, rtl);
+
+							if (level <= Unicode::MAX_BIDI_DEPTH
+									&& overflow_isolates == 0
+									&& overflow_embeddings == 0) {
+								valid_isolates++;
+								stack[depth++] = { level, X::ON, true };
+							} else {
+								overflow_isolates++;
+							}
+							break;
+						}
+
+						case X::PDI:
+							// X6a
+							if (overflow_isolates > 0) {
+								overflow_isolates--;
+							} else if (valid_isolates > 0) {
+								overflow_embeddings = 0;
+								while (!stack[depth - 1].isolate) {
+									depth--;
+								}
+								depth--;
+								valid_isolates--;
+							}
+
+							levels[i] = stack[depth - 1].level;
+							if (stack[depth - 1].override_status != X::ON) {
+								types[i] = stack[depth - 1].override_status;
+							}
+							break;
+
+						case X::PDF:
+							// X7
+							if (overflow_isolates > 0) {
+								// nothing
+							} else if (overflow_embeddings > 0) {
+								overflow_embeddings--;
+							} else if (!stack[depth - 1].isolate && depth >= 2) {
+								depth--;
+							}
+							levels[i] = stack[depth - 1].level;
+							break;
+
+						case X::B:
+							// X8, a paragraph separator ends everything
+							levels[i] = paragraph_level;
+							depth = 1;
+							overflow_isolates = 0;
+							overflow_embeddings = 0;
+							valid_isolates = 0;
+							break;
+
+						case X::BN:
+							levels[i] = stack[depth - 1].level;
+							break;
+
+						default:
+							// X6
+							levels[i] = stack[depth - 1].level;
+							if (stack[depth - 1].override_status != X::ON) {
+								types[i] = stack[depth - 1].override_status;
+							}
+							break;
+					}
+				}
+			}
+
+			// X9 and X10, then the rest for each sequence
+			void resolve_isolating_run_sequences() {
+				// the codepoints left after X9
+				std::vector<size_t> kept;
+				kept.reserve(len);
+				for (size_t i = 0; i < len; i++) {
+					if (!is_removed(i)) kept.push_back(i);
+				}
+
+				// the level runs, as the index in kept of their first codepoint
+				std::vector<size_t> run_starts;
+				std::vector<size_t> run_at(len, NONE);
+				for (size_t k = 0; k < kept.size(); k++) {
+					if (k == 0 || levels[kept[k]] != levels[kept[k - 1]]) {
+						run_at[kept[k]] = run_starts.size();
+						run_starts.push_back(k);
+					}
+				}
+				run_starts.push_back(kept.size());
+
+				std::vector<size_t> sequence;
+				for (size_t r = 0; r + 1 < run_starts.size(); r++) {
+					const size_t first = kept[run_starts[r]];
+
+					// this continues the sequence of its isolate initiator
+					if (initial[first] == X::PDI && matching_initiator[first] != NONE) {
+						continue;
+					}
+
+					sequence.clear();
+					size_t run = r;
+					while (true) {
+						for (size_t k = run_starts[run]; k < run_starts[run + 1]; k++) {
+							sequence.push_back(kept[k]);
+						}
+
+						const size_t last = sequence.back();
+						if (!is(initial[last], ISOLATE_INITIATORS) || matching_pdi[last] == NONE) break;
+
+						run = run_at[matching_pdi[last]];
+						if (run == NONE) break;
+					}
+
+					resolve_sequence(sequence);
+				}
+			}
+
+			void resolve_sequence(const std::vector<size_t>& sequence) {
+				const size_t n = sequence.size();
+				const bidi_level_t level = levels[sequence[0]];
+
+				// the levels of the codepoints around the sequence, ignoring
+				// the ones X9 removed
+				bidi_level_t before = paragraph_level;
+				for (size_t i = sequence[0]; i > 0; i--) {
+					if (!is_removed(i - 1)) {
+						before = levels[i - 1];
+						break;
+					}
+				}
+
+				bidi_level_t after = paragraph_level;
+				const size_t last = sequence[n - 1];
+				if (!is(initial[last], ISOLATE_INITIATORS)) {
+					for (size_t i = last + 1; i < len; i++) {
+						if (!is_removed(i)) {
+							after = levels[i];
+							break;
+						}
+					}
+				}
+
+				const BidiClass sos = class_of(std::max(level, before));
+				const BidiClass eos = class_of(std::max(level, after));
+				const BidiClass embedding = class_of(level);
+
+				auto t = [&](size_t k) -> BidiClass& { return types[sequence[k]]; };
+
+				// W1
+				BidiClass previous = sos;
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) == X::NSM) {
+						t(k) = is(previous, ISOLATE_INITIATORS | mask(X::PDI)) ? X::ON : previous;
+					}
+					previous = t(k);
+				}
+
+				// W2 and W3
+				BidiClass last_strong = sos;
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) == X::L || t(k) == X::R || t(k) == X::AL) {
+						last_strong = t(k);
+					} else if (t(k) == X::EN && last_strong == X::AL) {
+						t(k) = X::AN;
+					}
+				}
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) == X::AL) t(k) = X::R;
+				}
+
+				// W4
+				for (size_t k = 1; k + 1 < n; k++) {
+					if (t(k) == X::ES && t(k - 1) == X::EN && t(k + 1) == X::EN) {
+						t(k) = X::EN;
+					} else if (t(k) == X::CS && t(k - 1) == t(k + 1)
+							&& (t(k - 1) == X::EN || t(k - 1) == X::AN)) {
+						t(k) = t(k - 1);
+					}
+				}
+
+				// W5
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) != X::ET) continue;
+
+					size_t end = k;
+					while (end < n && t(end) == X::ET) end++;
+
+					if ((k > 0 && t(k - 1) == X::EN) || (end < n && t(end) == X::EN)) {
+						for (size_t j = k; j < end; j++) t(j) = X::EN;
+					}
+					k = end;
+				}
+
+				// W6
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) == X::ES || t(k) == X::ET || t(k) == X::CS) t(k) = X::ON;
+				}
+
+				// W7
+				last_strong = sos;
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) == X::L || t(k) == X::R) {
+						last_strong = t(k);
+					} else if (t(k) == X::EN && last_strong == X::L) {
+						t(k) = X::L;
+					}
+				}
+
+				resolve_brackets(sequence, sos, embedding);
+
+				// N1 and N2
+				for (size_t k = 0; k < n; k++) {
+					if (!is(t(k), NEUTRALS)) continue;
+
+					size_t end = k;
+					while (end < n && is(t(end), NEUTRALS)) end++;
+
+					const BidiClass leading = k == 0 ? sos : strong_direction(t(k - 1));
+					const BidiClass trailing = end == n ? eos : strong_direction(t(end));
+					const BidiClass resolved = leading == trailing ? leading : embedding;
+
+					for (size_t j = k; j < end; j++) t(j) = resolved;
+					k = end;
+				}
+
+				// I1 and I2
+				for (size_t k = 0; k < n; k++) {
+					bidi_level_t& x = levels[sequence[k]];
+					if (direction_of(x) == 0) {
+						if (t(k) == X::R) x += 1;
+						else if (t(k) == X::AN || t(k) == X::EN) x += 2;
+					} else {
+						if (t(k) == X::L || t(k) == X::EN || t(k) == X::AN) x += 1;
+					}
+				}
+			}
+
+			// N0
+			void resolve_brackets(const std::vector<size_t>& sequence, BidiClass sos, BidiClass embedding) {
+				const size_t n = sequence.size();
+				auto t = [&](size_t k) -> BidiClass& { return types[sequence[k]]; };
+
+				// BD16
+				struct Opening {
+					codepoint_t id;
+					size_t position;
+				};
+				Opening openings[MAX_BRACKET_DEPTH];
+				size_t depth = 0;
+
+				std::vector<std::pair<size_t, size_t>> pairs;
+
+				for (size_t k = 0; k < n; k++) {
+					if (t(k) != X::ON) continue;
+
+					const codepoint_t c = s[sequence[k]];
+					const BidiBracketType type = Unicode::get_bidi_bracket_type(c);
+
+					if (type == BidiBracketType::Open) {
+						if (depth == MAX_BRACKET_DEPTH) break;
+						openings[depth++] = { Unicode::get_bidi_bracket_pair_id(c), k };
+					} else if (type == BidiBracketType::Close) {
+						const codepoint_t id = Unicode::get_bidi_bracket_pair_id(c);
+						for (size_t d = depth; d > 0; d--) {
+							if (openings[d - 1].id == id) {
+								pairs.emplace_back(openings[d - 1].position, k);
+								depth = d - 1;
+								break;
+							}
+						}
+					}
+				}
+
+				std::sort(pairs.begin(), pairs.end());
+
+				auto set_bracket = [&](size_t k, BidiClass x) {
+					t(k) = x;
+					for (k++; k < n && initial[sequence[k]] == X::NSM; k++) {
+						t(k) = x;
+					}
+				};
+
+				for (const auto& pair : pairs) {
+					bool found_embedding = false;
+					bool found_opposite = false;
+
+					for (size_t k = pair.first + 1; k < pair.second; k++) {
+						const BidiClass x = strong_direction(t(k));
+						if (x == embedding) {
+							found_embedding = true;
+							break;
+						}
+						if (x != X::ON) found_opposite = true;
+					}
+
+					BidiClass resolved;
+					if (found_embedding) {
+						resolved = embedding;
+					} else if (found_opposite) {
+						// the context before the brackets decides
+						resolved = sos;
+						for (size_t k = pair.first; k > 0; k--) {
+							const BidiClass x = strong_direction(t(k - 1));
+							if (x != X::ON) {
+								resolved = x;
+								break;
+							}
+						}
+					} else {
+						continue;
+					}
+
+					set_bracket(pair.first, resolved);
+					set_bracket(pair.second, resolved);
+				}
+			}
+
+			// the codepoints X9 removed take the level of the one before
+			void assign_removed_levels() {
+				for (size_t i = 0; i < len; i++) {
+					if (is_removed(i)) {
+						levels[i] = i == 0 ? paragraph_level : levels[i - 1];
+					}
+				}
+			}
+
+			// L1, for the paragraph as one line
+			void reset_whitespace_levels() {
+				size_t whitespace_begin = 0;
+				for (size_t i = 0; i < len; i++) {
+					const BidiClass x = initial[i];
+
+					if (x == X::S || x == X::B) {
+						for (size_t j = whitespace_begin; j <= i; j++) {
+							levels[j] = paragraph_level;
+						}
+					}
+
+					if (!is(x, TRAILING_WHITESPACE)) {
+						whitespace_begin = i + 1;
+					}
+				}
+
+				for (size_t j = whitespace_begin; j < len; j++) {
+					levels[j] = paragraph_level;
+				}
+			}
+	};
+}
+
+bidi_level_t Unicode::get_paragraph_level(const codepoint_t* s, size_t len) {
+	return Resolver::get_paragraph_level(s, len);
+}
+
+bool Unicode::needs_bidi(const codepoint_t* s, size_t len) {
+	// a block at a time, or'ing the classes together without branching
+	BidiClass types[BLOCK_LEN];
+	for (size_t i = 0; i < len; i += BLOCK_LEN) {
+		const size_t n = std::min(len - i, BLOCK_LEN);
+		get_bidi_class(s + i, n, types);
+
+		uint32_t any = 0;
+		for (size_t j = 0; j < n; j++) {
+			any |= mask(types[j]);
+		}
+		if (any & NEEDS_BIDI) return true;
+	}
+	return false;
+}
+
+BidiParagraph::BidiParagraph(
+		const codepoint_t* s, size_t len,
+		BidiDirection direction)
+	: len(len) {
+
+	if (direction == BidiDirection::RTL) {
+		paragraph_level = 1;
+	} else if (!needs_bidi(s, len)) {
+		// without R or AL the paragraph is LTR, and everything is at level 0
+		return;
+	} else if (direction == BidiDirection::Auto) {
+		paragraph_level = Unicode::get_paragraph_level(s, len);
+	}
+
+	if (len == 0) return;
+
+	Resolver resolver(s, len, paragraph_level, levels);
+	resolver.resolve();
+}
+
+void BidiParagraph::get_visual_order(size_t begin, size_t end, size_t* out) const {
+	const size_t n = end - begin;
+	for (size_t i = 0; i < n; i++) {
+		out[i] = begin + i;
+	}
+
+	if (levels.empty() || n == 0) return;
+
+	bidi_level_t highest = 0;
+	bidi_level_t lowest_odd = MAX_BIDI_DEPTH + 2;
+	for (size_t i = begin; i < end; i++) {
+		highest = std::max(highest, levels[i]);
+		if (levels[i] & 1) {
+			lowest_odd = std::min(lowest_odd, levels[i]);
+		}
+	}
+
+	// L2: from the highest level down to the lowest odd one, reverse
+	// every run at that level or higher
+	for (bidi_level_t level = highest; level >= lowest_odd; level--) {
+		size_t i = 0;
+		while (i < n) {
+			if (levels[out[i]] < level) {
+				i++;
+				continue;
+			}
+
+			size_t run_end = i;
+			while (run_end < n && levels[out[run_end]] >= level) run_end++;
+
+			std::reverse(out + i, out + run_end);
+			i = run_end;
+		}
+	}
+}
+
+string_t Unicode::reorder_visually(const string_t& s, const BidiParagraph& paragraph) {
+	if (paragraph.is_ltr()) return s;
+
+	const size_t len = s.size();
+
+	std::vector<size_t> order(len);
+	paragraph.get_visual_order(0, len, order.data());
+
+	std::vector<BidiClass> types(len);
+	get_bidi_class(s.data(), len, types.data());
+
+	// the first codepoint of the grapheme cluster of each codepoint
+	std::vector<size_t> cluster_begin(len);
+	for (size_t i = 0; i < len;) {
+		const size_t end = next_grapheme_cluster_break(s.data(), len, i);
+		for (size_t j = i; j < end; j++) {
+			cluster_begin[j] = i;
+		}
+		i = end;
+	}
+
+	string_t ret;
+	ret.reserve(len);
+
+	auto add = [&](size_t i) {
+		if (is(types[i], EXPLICIT_FORMATTING)) return;
+		ret.push_back((paragraph.get_level(i) & 1) ? get_bidi_mirroring_glyph(s[i]) : s[i]);
+	};
+
+	for (size_t i = 0; i < len;) {
+		const size_t x = order[i];
+
+		if ((paragraph.get_level(x) & 1) == 0) {
+			add(x);
+			i++;
+			continue;
+		}
+
+		// a reversed cluster, which goes back the right way round
+		size_t end = i + 1;
+		while (end < len && order[end] + 1 == order[end - 1]
+				&& cluster_begin[order[end]] == cluster_begin[x]) {
+			end++;
+		}
+		for (size_t j = end; j > i; j--) {
+			add(order[j - 1]);
+		}
+		i = end;
+	}
+
+	return ret;
+}
+
+string_t Unicode::reorder_visually(const string_t& s, BidiDirection direction) {
+	return reorder_visually(s, BidiParagraph(s, direction));
+}
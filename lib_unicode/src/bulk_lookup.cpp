@@ -0,0 +1,50 @@
+#include "unicode.hpp"
+
+#include <algorithm>
+
+using Unicode::codepoint_t;
+using Unicode::GeneralCategory;
+
+// codepoints per word of a match mask
+constexpr size_t BLOCK_LEN = 64;
+
+// The inner loops are branchless, so they are left for the compiler to
+// vectorize.
+
+void Unicode::match_simple_properties(
+		const codepoint_t* s, size_t len,
+		uint64_t flags,
+		uint64_t* out) {
+
+	uint64_t block[BLOCK_LEN];
+
+	for (size_t i = 0; i < len; i += BLOCK_LEN) {
+		const size_t n = std::min(BLOCK_LEN, len - i);
+		get_simple_properties(s + i, n, block);
+
+		uint64_t bits = 0;
+		for (size_t j = 0; j < n; j++) {
+			bits |= uint64_t((block[j] & flags) != 0) << j;
+		}
+		out[i / BLOCK_LEN] = bits;
+	}
+}
+
+void Unicode::match_general_categories(
+		const codepoint_t* s, size_t len,
+		uint32_t category_mask,
+		uint64_t* out) {
+
+	GeneralCategory block[BLOCK_LEN];
+
+	for (size_t i = 0; i < len; i += BLOCK_LEN) {
+		const size_t n = std::min(BLOCK_LEN, len - i);
+		get_general_category(s + i, n, block);
+
+		uint64_t bits = 0;
+		for (size_t j = 0; j < n; j++) {
+			bits |= uint64_t((general_category_mask(block[j]) & category_mask) != 0) << j;
+		}
+		out[i / BLOCK_LEN] = bits;
+	}
+}
@@ -0,0 +1,215 @@
+#include "unicode.hpp"
+
+#include <utility>
+
+using Unicode::codepoint_t;
+using Unicode::string_t;
+
+namespace {
+
+	typedef size_t (*full_mapping_func)(codepoint_t, codepoint_t*);
+	typedef codepoint_t (*simple_mapping_func)(codepoint_t);
+
+	inline codepoint_t ascii_to_lower(codepoint_t x) {
+		return (x >= 'A' && x <= 'Z') ? x + 0x20 : x;
+	}
+
+	inline codepoint_t ascii_to_upper(codepoint_t x) {
+		return (x >= 'a' && x <= 'z') ? x - 0x20 : x;
+	}
+
+	// Table 3-17, Final_Sigma: C is preceded by a cased letter (with any number
+	// of case-ignorables in between) and C is not followed by one
+	bool is_final_sigma(const string_t& s, size_t i) {
+		bool preceded = false;
+		for (size_t j = i; j > 0; j--) {
+			const codepoint_t x = s[j - 1];
+			if (Unicode::is_case_ignorable(x)) continue;
+			preceded = Unicode::is_cased(x);
+			break;
+		}
+
+		if (!preceded) return false;
+
+		for (size_t j = i + 1; j < s.size(); j++) {
+			const codepoint_t x = s[j];
+			if (Unicode::is_case_ignorable(x)) continue;
+			return !Unicode::is_cased(x);
+		}
+
+		return true;
+	}
+
+	// returns how many codepoints were written into out
+	inline size_t map_one(
+			const string_t& s,
+			size_t i,
+			full_mapping_func full,
+			codepoint_t (*ascii)(codepoint_t),
+			bool lower,
+			codepoint_t* out) {
+
+		const codepoint_t x = s[i];
+
+		if (x < 0x80) {
+			out[0] = ascii(x);
+			return 1;
+		}
+
+		// GREEK CAPITAL LETTER SIGMA
+		if (lower && x == 0x03A3) {
+			out[0] = is_final_sigma(s, i) ? 0x03C2 : 0x03C3;
+			return 1;
+		}
+
+		return full(x, out);
+	}
+
+	string_t map_full(
+			const string_t& s,
+			full_mapping_func full,
+			codepoint_t (*ascii)(codepoint_t),
+			bool lower) {
+
+		string_t ret;
+		ret.reserve(s.size());
+
+		codepoint_t buf[Unicode::MAX_CASE_MAPPING_LEN];
+
+		for (size_t i = 0; i < s.size(); i++) {
+			const size_t len = map_one(s, i, full, ascii, lower, buf);
+			ret.append(buf, len);
+		}
+
+		return ret;
+	}
+
+	void map_full_in_place(
+			string_t& s,
+			full_mapping_func full,
+			codepoint_t (*ascii)(codepoint_t),
+			bool lower) {
+
+		codepoint_t buf[Unicode::MAX_CASE_MAPPING_LEN];
+
+		for (size_t i = 0; i < s.size(); i++) {
+			const size_t len = map_one(s, i, full, ascii, lower, buf);
+
+			if (len == 1) {
+				s[i] = buf[0];
+				continue;
+			}
+
+			// This one expands, so the rest goes into a new string. It is
+			// still mapped from s, which Final_Sigma needs the left of.
+			string_t ret;
+			ret.reserve(s.size() + len);
+			ret.append(s, 0, i);
+			ret.append(buf, len);
+			for (size_t j = i + 1; j < s.size(); j++) {
+				const size_t n = map_one(s, j, full, ascii, lower, buf);
+				ret.append(buf, n);
+			}
+			s = std::move(ret);
+			return;
+		}
+	}
+
+	void map_simple_in_place(
+			codepoint_t* s,
+			size_t len,
+			simple_mapping_func simple,
+			codepoint_t (*ascii)(codepoint_t)) {
+
+		for (size_t i = 0; i < len; i++) {
+			const codepoint_t x = s[i];
+			s[i] = x < 0x80 ? ascii(x) : simple(x);
+		}
+	}
+
+}
+
+string_t Unicode::to_lower(const string_t& s) {
+	return map_full(s, Unicode::get_full_lowercase, ascii_to_lower, true);
+}
+
+string_t Unicode::to_upper(const string_t& s) {
+	return map_full(s, Unicode::get_full_uppercase, ascii_to_upper, false);
+}
+
+string_t Unicode::casefold(const string_t& s) {
+	return map_full(s, Unicode::get_full_casefold, ascii_to_lower, false);
+}
+
+void Unicode::to_lower_in_place(string_t& s) {
+	map_full_in_place(s, Unicode::get_full_lowercase, ascii_to_lower, true);
+}
+
+void Unicode::to_upper_in_place(string_t& s) {
+	map_full_in_place(s, Unicode::get_full_uppercase, ascii_to_upper, false);
+}
+
+void Unicode::casefold_in_place(string_t& s) {
+	map_full_in_place(s, Unicode::get_full_casefold, ascii_to_lower, false);
+}
+
+void Unicode::to_lower_in_place(codepoint_t* s, size_t len) {
+	map_simple_in_place(s, len, Unicode::to_lower, ascii_to_lower);
+}
+
+void Unicode::to_upper_in_place(codepoint_t* s, size_t len) {
+	map_simple_in_place(s, len, Unicode::to_upper, ascii_to_upper);
+}
+
+void Unicode::casefold_in_place(codepoint_t* s, size_t len) {
+	map_simple_in_place(s, len, Unicode::casefold, ascii_to_lower);
+}
+
+namespace {
+
+	// walks over the full case folding of a string, one codepoint at a time
+	class FoldCursor {
+		public:
+			FoldCursor(const string_t& s) : s(s) {}
+
+			bool has_next() {
+				return buf_pos < buf_len || pos < s.size();
+			}
+
+			codepoint_t next() {
+				if (buf_pos < buf_len) {
+					return buf[buf_pos++];
+				}
+
+				const codepoint_t x = s[pos++];
+				if (x < 0x80) {
+					return ascii_to_lower(x);
+				}
+
+				buf_len = Unicode::get_full_casefold(x, buf);
+				buf_pos = 1;
+				return buf[0];
+			}
+
+		private:
+			const string_t& s;
+			size_t pos = 0;
+			codepoint_t buf[Unicode::MAX_CASE_MAPPING_LEN];
+			size_t buf_pos = 0;
+			size_t buf_len = 0;
+	};
+
+}
+
+bool Unicode::equals_ignore_case(const string_t& a, const string_t& b) {
+	FoldCursor ca(a);
+	FoldCursor cb(b);
+
+	while (ca.has_next() && cb.has_next()) {
+		if (ca.next() != cb.next()) {
+			return false;
+		}
+	}
+
+	return !ca.has_next() && !cb.has_next();
+}
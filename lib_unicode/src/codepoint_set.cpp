@@ -0,0 +1,214 @@
+#include "unicode_codepoint_set.hpp"
+
+#include <algorithm>
+
+using Unicode::codepoint_t;
+using Unicode::CodepointSet;
+
+namespace {
+	// one past the last codepoint, where every inversion list ends
+	constexpr codepoint_t END = Unicode::MAX_CODEPOINT + 1;
+
+	// Merges two inversion lists, keeping codepoints for which
+	// op(in a, in b) is true.
+	template <typename Op>
+	std::vector<codepoint_t> combine(
+			const std::vector<codepoint_t>& a,
+			const std::vector<codepoint_t>& b,
+			Op op) {
+
+		std::vector<codepoint_t> ret;
+		ret.reserve(a.size() + b.size());
+
+		size_t i = 0;
+		size_t j = 0;
+		bool in_a = false;
+		bool in_b = false;
+		bool inside = false;
+
+		while (i < a.size() || j < b.size()) {
+			const codepoint_t x = std::min(
+					i < a.size() ? a[i] : END,
+					j < b.size() ? b[j] : END);
+
+			if (i < a.size() && a[i] == x) {
+				in_a = !in_a;
+				i++;
+			}
+			if (j < b.size() && b[j] == x) {
+				in_b = !in_b;
+				j++;
+			}
+
+			const bool now = op(in_a, in_b);
+			if (now != inside) {
+				ret.push_back(x);
+				inside = now;
+			}
+		}
+
+		return ret;
+	}
+}
+
+CodepointSet::CodepointSet() {
+	bitmap.fill(0);
+}
+
+CodepointSet::CodepointSet(std::initializer_list<codepoint_t> codepoints) {
+	std::vector<codepoint_t> sorted(codepoints);
+	std::sort(sorted.begin(), sorted.end());
+
+	for (const codepoint_t x : sorted) {
+		if (x > MAX_CODEPOINT) break;
+
+		if (!inversion_list.empty() && inversion_list.back() >= x) {
+			// a duplicate, or adjacent to the previous range
+			inversion_list.back() = std::max<codepoint_t>(inversion_list.back(), x + 1);
+		} else {
+			inversion_list.push_back(x);
+			inversion_list.push_back(x + 1);
+		}
+	}
+
+	build_bitmap();
+}
+
+CodepointSet::CodepointSet(std::vector<codepoint_t>&& inversion_list) :
+	inversion_list(std::move(inversion_list)) {
+	build_bitmap();
+}
+
+CodepointSet CodepointSet::from_range(codepoint_t first, codepoint_t last) {
+	last = std::min(last, MAX_CODEPOINT);
+	if (first > last) {
+		return CodepointSet();
+	}
+	return CodepointSet(std::vector<codepoint_t>{ first, last + 1 });
+}
+
+CodepointSet CodepointSet::all() {
+	return from_range(0, MAX_CODEPOINT);
+}
+
+bool CodepointSet::contains_above_bitmap(codepoint_t x) const {
+	// inside if an odd number of boundaries are at or below x
+	const auto it = std::upper_bound(inversion_list.begin(), inversion_list.end(), x);
+	return (it - inversion_list.begin()) % 2 == 1;
+}
+
+void CodepointSet::match(const codepoint_t* s, size_t len, uint64_t* out) const {
+	for (size_t i = 0; i < len; i += 64) {
+		const size_t n = std::min<size_t>(64, len - i);
+
+		uint64_t bits = 0;
+		for (size_t j = 0; j < n; j++) {
+			bits |= uint64_t(contains(s[i + j])) << j;
+		}
+		out[i / 64] = bits;
+	}
+}
+
+size_t CodepointSet::size() const {
+	size_t ret = 0;
+	for (size_t i = 0; i < inversion_list.size(); i += 2) {
+		ret += inversion_list[i + 1] - inversion_list[i];
+	}
+	return ret;
+}
+
+void CodepointSet::add(codepoint_t x) {
+	add_range(x, x);
+}
+
+void CodepointSet::add_range(codepoint_t first, codepoint_t last) {
+	*this |= from_range(first, last);
+}
+
+CodepointSet CodepointSet::operator|(const CodepointSet& other) const {
+	return CodepointSet(combine(inversion_list, other.inversion_list,
+			[](bool a, bool b) { return a || b; }));
+}
+
+CodepointSet CodepointSet::operator&(const CodepointSet& other) const {
+	return CodepointSet(combine(inversion_list, other.inversion_list,
+			[](bool a, bool b) { return a && b; }));
+}
+
+CodepointSet CodepointSet::operator-(const CodepointSet& other) const {
+	return CodepointSet(combine(inversion_list, other.inversion_list,
+			[](bool a, bool b) { return a && !b; }));
+}
+
+CodepointSet CodepointSet::operator~() const {
+	// flip membership at 0 and at the end
+	std::vector<codepoint_t> ret;
+	ret.reserve(inversion_list.size() + 2);
+
+	if (inversion_list.empty() || inversion_list.front() != 0) {
+		ret.push_back(0);
+		ret.insert(ret.end(), inversion_list.begin(), inversion_list.end());
+	} else {
+		ret.insert(ret.end(), inversion_list.begin() + 1, inversion_list.end());
+	}
+
+	if (!ret.empty() && ret.back() == END) {
+		ret.pop_back();
+	} else {
+		ret.push_back(END);
+	}
+
+	return CodepointSet(std::move(ret));
+}
+
+CodepointSet& CodepointSet::operator|=(const CodepointSet& other) {
+	return *this = *this | other;
+}
+
+CodepointSet& CodepointSet::operator&=(const CodepointSet& other) {
+	return *this = *this & other;
+}
+
+CodepointSet& CodepointSet::operator-=(const CodepointSet& other) {
+	return *this = *this - other;
+}
+
+void CodepointSet::build_bitmap() {
+	bitmap.fill(0);
+
+	for (size_t i = 0; i < inversion_list.size(); i += 2) {
+		const codepoint_t first = inversion_list[i];
+		if (first > BITMAP_MAX) break;
+		const codepoint_t last = std::min<codepoint_t>(inversion_list[i + 1] - 1, BITMAP_MAX);
+
+		// whole words at a time where possible
+		codepoint_t x = first;
+		for (; x <= last && x % 64 != 0; x++) {
+			bitmap[x / 64] |= uint64_t(1) << (x % 64);
+		}
+		for (; x + 63 <= last; x += 64) {
+			bitmap[x / 64] = ~uint64_t(0);
+		}
+		for (; x <= last; x++) {
+			bitmap[x / 64] |= uint64_t(1) << (x % 64);
+		}
+	}
+}
+
+std::string Unicode::to_string(const CodepointSet& x) {
+	const auto& list = x.get_inversion_list();
+
+	std::string ret = "[";
+	for (size_t i = 0; i < list.size(); i += 2) {
+		if (i != 0) ret += " ";
+
+		ret += to_string(list[i]);
+		if (list[i + 1] - 1 != list[i]) {
+			ret += "..";
+			ret += to_string(list[i + 1] - 1);
+		}
+	}
+	ret += "]";
+
+	return ret;
+}
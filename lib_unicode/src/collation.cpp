@@ -0,0 +1,119 @@
+#include "unicode_collation.hpp"
+#include "unicode_normalization.hpp"
+
+#include <algorithm>
+
+using Unicode::codepoint_t;
+using Unicode::CollationElement;
+
+std::vector<CollationElement> Unicode::get_collation_elements(const codepoint_t* s, size_t len) {
+	// S1.1
+	string_t nfd(s, len);
+	normalize_in_place(nfd, NormalizationForm::NFD);
+
+	std::vector<CollationElement> ret;
+	ret.reserve(nfd.size());
+
+	CollationElement elements[MAX_COLLATION_ELEMENTS];
+	size_t elements_len = 0;
+
+	size_t i = 0;
+	while (i < nfd.size()) {
+		codepoint_t seq[3] = { nfd[i] };
+		size_t seq_len = 1;
+
+		if (starts_contraction(nfd[i])) {
+			// S2.1, the longest contiguous match
+			for (size_t n = std::min<size_t>(3, nfd.size() - i); n >= 2; n--) {
+				if (get_ducet_elements(&nfd[i], n, elements, &elements_len)) {
+					std::copy(&nfd[i], &nfd[i + n], seq);
+					seq_len = n;
+					break;
+				}
+			}
+		}
+
+		const size_t next = i + seq_len;
+
+		if (starts_contraction(nfd[i])) {
+			// S2.1.1 - S2.1.3, unblocked non-starters after the match can
+			// extend it, and are then taken out of the string
+			uint8_t blocking_ccc = 0;
+
+			size_t j = next;
+			while (j < nfd.size() && seq_len < 3) {
+				const uint8_t ccc = get_canonical_combining_class(nfd[j]);
+				if (ccc == 0) break;
+
+				if (ccc > blocking_ccc) {
+					seq[seq_len] = nfd[j];
+					if (get_ducet_elements(seq, seq_len + 1, elements, &elements_len)) {
+						seq_len++;
+						nfd.erase(j, 1);
+						continue;
+					}
+				}
+
+				blocking_ccc = std::max(blocking_ccc, ccc);
+				j++;
+			}
+		}
+
+		// S2.2
+		if (get_ducet_elements(seq, seq_len, elements, &elements_len)) {
+			ret.insert(ret.end(), elements, elements + elements_len);
+		} else {
+			get_implicit_collation_elements(seq[0], elements);
+			ret.insert(ret.end(), elements, elements + 2);
+		}
+
+		i = next;
+	}
+
+	return ret;
+}
+
+Unicode::sort_key_t Unicode::get_sort_key(
+		const codepoint_t* s, size_t len,
+		CollationStrength strength) {
+
+	const auto elements = get_collation_elements(s, len);
+	const int levels = static_cast<int>(strength);
+
+	sort_key_t ret;
+	ret.reserve(elements.size() * 2 * levels + 2 * (levels - 1));
+
+	// big-endian, so that comparing bytes compares weights
+	auto append = [&ret](uint16_t weight) {
+		ret.push_back(static_cast<char>(weight >> 8));
+		ret.push_back(static_cast<char>(weight & 0xFF));
+	};
+
+	// S3, one level after another, with zero weights left out and a 0000
+	// separating the levels
+	for (int level = 1; level <= levels; level++) {
+		if (level > 1) {
+			append(0);
+		}
+
+		for (const CollationElement& e : elements) {
+			const uint16_t weight =
+				level == 1 ? e.primary :
+				level == 2 ? e.secondary :
+				e.tertiary;
+
+			if (weight != 0) {
+				append(weight);
+			}
+		}
+	}
+
+	return ret;
+}
+
+int Unicode::collate(
+		const string_t& a,
+		const string_t& b,
+		CollationStrength strength) {
+	return get_sort_key(a, strength).compare(get_sort_key(b, strength));
+}
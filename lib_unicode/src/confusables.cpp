@@ -0,0 +1,30 @@
+#include "unicode_confusables.hpp"
+#include "unicode_normalization.hpp"
+
+using Unicode::codepoint_t;
+using Unicode::string_t;
+using Unicode::NormalizationForm;
+
+string_t Unicode::get_skeleton(const string_t& s) {
+	const string_t nfd = normalize(s, NormalizationForm::NFD);
+
+	string_t ret;
+	ret.reserve(nfd.size());
+
+	codepoint_t prototype[MAX_CONFUSABLE_PROTOTYPE_LEN];
+	for (const codepoint_t x : nfd) {
+		if (is_default_ignorable_code_point(x)) continue;
+
+		const size_t len = get_confusable_prototype(x, prototype);
+		ret.append(prototype, len);
+	}
+
+	// does nothing (and does not allocate) if no prototype decomposes or
+	// puts combining marks out of order, which is the usual case
+	normalize_in_place(ret, NormalizationForm::NFD);
+	return ret;
+}
+
+bool Unicode::are_confusable(const string_t& a, const string_t& b) {
+	return get_skeleton(a) == get_skeleton(b);
+}
@@ -0,0 +1,97 @@
+#include "unicode.hpp"
+#include "unicode_emoji.hpp"
+
+using Unicode::codepoint_t;
+using Unicode::AmbiguousWidth;
+using Unicode::GraphemeClusterBreak;
+
+constexpr codepoint_t VARIATION_SELECTOR_16 = 0xFE0F;
+
+// below this, every codepoint is a grapheme cluster of its own (other than
+// CR LF, which is zero width either way)
+constexpr codepoint_t FIRST_JOINING_CODEPOINT = 0x0300;
+
+namespace {
+
+	// whether a cluster goes on past a codepoint before x, when x is not a
+	// regional indicator or a Hangul jamo (GB9 and GB9a)
+	inline bool extends_cluster(codepoint_t x) {
+		const GraphemeClusterBreak gcb = Unicode::get_grapheme_cluster_break(x);
+		return gcb == GraphemeClusterBreak::Extend
+			|| gcb == GraphemeClusterBreak::ZWJ
+			|| gcb == GraphemeClusterBreak::SpacingMark;
+	}
+
+}
+
+size_t Unicode::get_cluster_display_width(
+		const codepoint_t* s, size_t len,
+		AmbiguousWidth ambiguous) {
+
+	if (len == 0) return 0;
+
+	if (is_emoji_sequence(s, len)) return 2;
+
+	// a flag is a pair of regional indicators, even one that is not RGI
+	if (len >= 2
+			&& is_regional_indicator(s[0])
+			&& is_regional_indicator(s[1])) {
+		return 2;
+	}
+
+	size_t ret = 0;
+	bool emoji_presentation = false;
+
+	for (size_t i = 0; i < len; i++) {
+		const size_t width = get_display_width(s[i], ambiguous);
+		if (width > ret) ret = width;
+
+		if (s[i] == VARIATION_SELECTOR_16) {
+			emoji_presentation = true;
+		}
+	}
+
+	// a text-default emoji followed by VS16 is drawn as an emoji
+	if (emoji_presentation && is_emoji(s[0])) {
+		return 2;
+	}
+
+	return ret;
+}
+
+size_t Unicode::get_display_width(
+		const codepoint_t* s, size_t len,
+		AmbiguousWidth ambiguous) {
+
+	size_t ret = 0;
+	size_t i = 0;
+
+	while (i < len) {
+		const codepoint_t x = s[i];
+
+		// fast path, no segmentation needed if nothing can join onto x
+		if (x < FIRST_JOINING_CODEPOINT
+				&& (i + 1 == len || s[i + 1] < FIRST_JOINING_CODEPOINT)) {
+			ret += (x >= 0x20 && x < 0x7F) ? 1 : get_display_width(x, ambiguous);
+			i++;
+			continue;
+		}
+
+		// A whole emoji sequence is one cluster, unless something extends
+		// it. No sequence ends in something that joins onto the next
+		// codepoint, and a flag is only ever a pair, so that is all that
+		// needs checking to skip segmenting it.
+		const size_t emoji_len = match_emoji_sequence(s + i, len - i);
+		if (emoji_len > 0 && (i + emoji_len == len || !extends_cluster(s[i + emoji_len]))) {
+			ret += 2;
+			i += emoji_len;
+			continue;
+		}
+
+		const size_t end = next_grapheme_cluster_break(s, len, i);
+		ret += get_cluster_display_width(s + i, end - i, ambiguous);
+		i = end;
+	}
+
+	return ret;
+}
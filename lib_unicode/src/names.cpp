@@ -0,0 +1,244 @@
+#include "unicode_names.hpp"
+
+#include <cstring>
+
+using Unicode::codepoint_t;
+namespace name_table = Unicode::name_table;
+
+namespace {
+	// Hangul syllables, see section 3.12 of the standard
+	constexpr codepoint_t HANGUL_S_BASE = 0xAC00;
+	constexpr size_t HANGUL_L_COUNT = 19;
+	constexpr size_t HANGUL_V_COUNT = 21;
+	constexpr size_t HANGUL_T_COUNT = 28;
+	constexpr size_t HANGUL_N_COUNT = HANGUL_V_COUNT * HANGUL_T_COUNT;
+	constexpr size_t HANGUL_S_COUNT = HANGUL_L_COUNT * HANGUL_N_COUNT;
+
+	constexpr const char* HANGUL_PREFIX = "HANGUL SYLLABLE ";
+
+	// the Jamo_Short_Name of the leading consonants, vowels, and trailing
+	// consonants, from Jamo.txt
+	const char* const JAMO_L[HANGUL_L_COUNT] = {
+		"G", "GG", "N", "D", "DD", "R", "M", "B", "BB", "S",
+		"SS", "", "J", "JJ", "C", "K", "T", "P", "H" };
+
+	const char* const JAMO_V[HANGUL_V_COUNT] = {
+		"A", "AE", "YA", "YAE", "EO", "E", "YEO", "YE", "O", "WA",
+		"WAE", "OE", "YO", "U", "WEO", "WE", "WI", "YU", "EU", "YI",
+		"I" };
+
+	const char* const JAMO_T[HANGUL_T_COUNT] = {
+		"", "G", "GG", "GS", "N", "NJ", "NH", "D", "L", "LG",
+		"LM", "LB", "LS", "LT", "LP", "LH", "M", "B", "BS", "S",
+		"SS", "NG", "J", "C", "K", "T", "P", "H" };
+
+	// FNV-1a, as in gen_names.py
+	uint32_t name_hash(const char* s, size_t len) {
+		uint32_t ret = 0x811C9DC5;
+		for (size_t i = 0; i < len; i++) {
+			ret ^= static_cast<uint8_t>(s[i]);
+			ret *= 0x01000193;
+		}
+		return ret;
+	}
+
+	std::string to_ascii_upper(const std::string& s) {
+		std::string ret = s;
+		for (char& c : ret) {
+			if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+		}
+		return ret;
+	}
+
+	size_t append(char* out, size_t len, const char* s) {
+		const size_t n = strlen(s);
+		memcpy(out + len, s, n);
+		return len + n;
+	}
+
+	// at least 4 digits, like "U+XXXX"
+	size_t append_hex(char* out, size_t len, codepoint_t x) {
+		static const char HEX_CHARS[] = "0123456789ABCDEF";
+
+		size_t digits = 4;
+		while (digits < 6 && (x >> (4 * digits)) != 0) digits++;
+
+		for (size_t i = 0; i < digits; i++) {
+			out[len + i] = HEX_CHARS[(x >> (4 * (digits - 1 - i))) & 0xF];
+		}
+		return len + digits;
+	}
+
+	size_t get_hangul_name(codepoint_t x, char* out) {
+		const size_t s = x - HANGUL_S_BASE;
+		size_t len = append(out, 0, HANGUL_PREFIX);
+		len = append(out, len, JAMO_L[s / HANGUL_N_COUNT]);
+		len = append(out, len, JAMO_V[(s % HANGUL_N_COUNT) / HANGUL_T_COUNT]);
+		len = append(out, len, JAMO_T[s % HANGUL_T_COUNT]);
+		return len;
+	}
+
+	bool starts_with(const std::string& s, size_t pos, const char* prefix) {
+		const size_t n = strlen(prefix);
+		return s.size() - pos >= n && s.compare(pos, n, prefix) == 0;
+	}
+
+	// the syllable named name, where the jamo names can be ambiguous
+	// ("GG" or "G" + "G..."), so every split is tried
+	bool find_hangul(const std::string& name, codepoint_t* out) {
+		if (!starts_with(name, 0, HANGUL_PREFIX)) return false;
+		const size_t begin = strlen(HANGUL_PREFIX);
+
+		for (size_t l = 0; l < HANGUL_L_COUNT; l++) {
+			if (!starts_with(name, begin, JAMO_L[l])) continue;
+			const size_t after_l = begin + strlen(JAMO_L[l]);
+
+			for (size_t v = 0; v < HANGUL_V_COUNT; v++) {
+				if (!starts_with(name, after_l, JAMO_V[v])) continue;
+				const size_t after_v = after_l + strlen(JAMO_V[v]);
+
+				for (size_t t = 0; t < HANGUL_T_COUNT; t++) {
+					if (name.compare(after_v, std::string::npos, JAMO_T[t]) == 0) {
+						*out = HANGUL_S_BASE + (l * HANGUL_V_COUNT + v) * HANGUL_T_COUNT + t;
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	bool find_in_ranges(const std::string& name, codepoint_t* out) {
+		for (size_t i = 0; i < name_table::get_range_count(); i++) {
+			const name_table::Range& range = name_table::get_range(i);
+			if (!starts_with(name, 0, range.prefix)) continue;
+
+			const size_t begin = strlen(range.prefix);
+			const size_t digits = name.size() - begin;
+			if (digits < 4 || digits > 6) continue;
+
+			codepoint_t x = 0;
+			bool valid = true;
+			for (size_t j = begin; j < name.size(); j++) {
+				const char c = name[j];
+				if (c >= '0' && c <= '9') x = x * 16 + (c - '0');
+				else if (c >= 'A' && c <= 'F') x = x * 16 + (c - 'A' + 10);
+				else valid = false;
+			}
+
+			// and written the way get_name writes it, without extra zeros
+			char canonical[Unicode::MAX_NAME_LEN];
+			if (valid && x >= range.first && x <= range.last
+					&& append_hex(canonical, 0, x) == digits) {
+				*out = x;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// the name at rank in name order
+	std::string get_name_by_rank(size_t rank) {
+		char buffer[Unicode::MAX_NAME_LEN];
+		const size_t len = name_table::get_name(name_table::get_by_name(rank), buffer);
+		return std::string(buffer, len);
+	}
+
+	// the first rank for which pred(name) is false, pred being true for a
+	// leading part of the sorted names
+	template <typename Pred>
+	size_t partition_point(Pred pred) {
+		size_t begin = 0;
+		size_t end = name_table::size();
+		while (begin < end) {
+			const size_t mid = begin + (end - begin) / 2;
+			if (pred(get_name_by_rank(mid))) {
+				begin = mid + 1;
+			} else {
+				end = mid;
+			}
+		}
+		return begin;
+	}
+}
+
+size_t Unicode::get_name(codepoint_t x, char* out) {
+	const size_t i = name_table::find(x);
+	if (i != name_table::size()) {
+		return name_table::get_name(i, out);
+	}
+
+	if (x >= HANGUL_S_BASE && x < HANGUL_S_BASE + HANGUL_S_COUNT) {
+		return get_hangul_name(x, out);
+	}
+
+	for (size_t j = 0; j < name_table::get_range_count(); j++) {
+		const name_table::Range& range = name_table::get_range(j);
+		if (x >= range.first && x <= range.last) {
+			return append_hex(out, append(out, 0, range.prefix), x);
+		}
+	}
+
+	return 0;
+}
+
+std::string Unicode::get_name(codepoint_t x) {
+	char buffer[MAX_NAME_LEN];
+	return std::string(buffer, get_name(x, buffer));
+}
+
+std::string Unicode::to_string_with_name(codepoint_t x) {
+	std::string ret = to_string(x);
+
+	const std::string name = get_name(x);
+	if (!name.empty()) {
+		ret.push_back(' ');
+		ret += name;
+	}
+	return ret;
+}
+
+bool Unicode::find_by_name(const std::string& name, codepoint_t* out) {
+	if (name.empty() || name.size() > MAX_NAME_LEN) return false;
+
+	const std::string upper = to_ascii_upper(name);
+
+	// linear probing, until the name or an empty slot
+	const size_t slot_count = name_table::get_hash_slot_count();
+	size_t slot = name_hash(upper.data(), upper.size()) & (slot_count - 1);
+
+	char buffer[MAX_NAME_LEN];
+	while (true) {
+		const size_t i = name_table::get_hash_slot(slot);
+		if (i == name_table::size()) break;
+
+		const size_t len = name_table::get_name(i, buffer);
+		if (len == upper.size() && memcmp(buffer, upper.data(), len) == 0) {
+			*out = name_table::get_codepoint(i);
+			return true;
+		}
+
+		slot = (slot + 1) & (slot_count - 1);
+	}
+
+	return find_hangul(upper, out) || find_in_ranges(upper, out);
+}
+
+size_t Unicode::find_by_name_prefix(const std::string& prefix, codepoint_t* out, size_t out_len) {
+	const std::string upper = to_ascii_upper(prefix);
+
+	// the names starting with the prefix are the ones from the first that
+	// is not less than it, to the first whose beginning is greater than it
+	const size_t begin = partition_point([&](const std::string& name) {
+		return name < upper;
+	});
+	const size_t end = partition_point([&](const std::string& name) {
+		return name.compare(0, upper.size(), upper) <= 0;
+	});
+
+	for (size_t rank = begin; rank < end && rank - begin < out_len; rank++) {
+		out[rank - begin] = name_table::get_codepoint(name_table::get_by_name(rank));
+	}
+
+	return end - begin;
+}
@@ -0,0 +1,200 @@
+#include "unicode_normalization.hpp"
+
+#include <utility>
+
+using Unicode::codepoint_t;
+using Unicode::string_t;
+using Unicode::NormalizationForm;
+using Unicode::QuickCheck;
+
+namespace {
+
+	inline bool is_compat(NormalizationForm form) {
+		return form == NormalizationForm::NFKC
+			|| form == NormalizationForm::NFKD;
+	}
+
+	inline bool is_composed(NormalizationForm form) {
+		return form == NormalizationForm::NFC
+			|| form == NormalizationForm::NFKC;
+	}
+
+	// appends the full decomposition of s to out, and puts it in canonical order
+	void decompose(const string_t& s, bool compat, string_t& out) {
+		// everything below U+00A0 is its own decomposition
+		const codepoint_t threshold = Unicode::get_quick_check_threshold(NormalizationForm::NFKD);
+		const size_t start = out.size();
+
+		codepoint_t buf[Unicode::MAX_DECOMPOSITION_LEN];
+
+		for (const codepoint_t x : s) {
+			if (x < threshold) {
+				out.push_back(x);
+				continue;
+			}
+
+			const size_t len = Unicode::get_decomposition(x, compat, buf);
+			if (len == 0) {
+				out.push_back(x);
+			} else {
+				out.append(buf, len);
+			}
+		}
+
+		// canonical ordering algorithm (D109), a stable sort of every run of
+		// non-starters by their combining class
+		for (size_t i = start + 1; i < out.size(); i++) {
+			if (out[i] < threshold) continue;
+
+			const uint8_t ccc = Unicode::get_canonical_combining_class(out[i]);
+			if (ccc == 0) continue;
+
+			for (size_t j = i; j > start; j--) {
+				const uint8_t prev_ccc = Unicode::get_canonical_combining_class(out[j - 1]);
+				if (prev_ccc == 0 || prev_ccc <= ccc) break;
+				std::swap(out[j - 1], out[j]);
+			}
+		}
+	}
+
+	// canonical composition algorithm (D117), done in place
+	void compose(string_t& s) {
+		if (s.empty()) return;
+
+		size_t starter_pos = 0;
+		codepoint_t starter = s[0];
+
+		// 256 means "not preceded by a starter", so nothing can compose with it
+		int last_ccc = Unicode::get_canonical_combining_class(starter);
+		if (last_ccc != 0) last_ccc = 256;
+
+		size_t out_pos = 1;
+
+		for (size_t i = 1; i < s.size(); i++) {
+			const codepoint_t x = s[i];
+			const int ccc = Unicode::get_canonical_combining_class(x);
+
+			// a character is blocked from the starter if there is something in
+			// between with the same or a higher combining class
+			const codepoint_t composite = (last_ccc < ccc || last_ccc == 0)
+				? Unicode::get_composition(starter, x)
+				: 0;
+
+			if (composite != 0) {
+				s[starter_pos] = composite;
+				starter = composite;
+				continue;
+			}
+
+			if (ccc == 0) {
+				starter_pos = out_pos;
+				starter = x;
+			}
+
+			last_ccc = ccc;
+			s[out_pos++] = x;
+		}
+
+		s.resize(out_pos);
+	}
+
+	string_t normalize_always(const string_t& s, NormalizationForm form) {
+		string_t ret;
+		ret.reserve(s.size());
+
+		decompose(s, is_compat(form), ret);
+
+		if (is_composed(form)) {
+			compose(ret);
+		}
+
+		return ret;
+	}
+
+}
+
+QuickCheck Unicode::quick_check(const codepoint_t* s, size_t len, NormalizationForm form) {
+	const codepoint_t threshold = get_quick_check_threshold(form);
+
+	QuickCheck ret = QuickCheck::Yes;
+	uint8_t last_ccc = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		const codepoint_t x = s[i];
+
+		if (x < threshold) {
+			last_ccc = 0;
+			continue;
+		}
+
+		const uint8_t ccc = get_canonical_combining_class(x);
+		if (ccc != 0 && last_ccc > ccc) {
+			return QuickCheck::No;
+		}
+
+		switch (get_quick_check(x, form)) {
+			case QuickCheck::No:
+				return QuickCheck::No;
+			case QuickCheck::Maybe:
+				ret = QuickCheck::Maybe;
+				break;
+			default:
+				break;
+		}
+
+		last_ccc = ccc;
+	}
+
+	return ret;
+}
+
+bool Unicode::is_normalized(const string_t& s, NormalizationForm form) {
+	switch (quick_check(s, form)) {
+		case QuickCheck::Yes: return true;
+		case QuickCheck::No:  return false;
+		default: break;
+	}
+	return normalize_always(s, form) == s;
+}
+
+string_t Unicode::normalize(const string_t& s, NormalizationForm form) {
+	if (quick_check(s, form) == QuickCheck::Yes) {
+		return s;
+	}
+	return normalize_always(s, form);
+}
+
+bool Unicode::normalize_in_place(string_t& s, NormalizationForm form) {
+	if (quick_check(s, form) == QuickCheck::Yes) {
+		return false;
+	}
+
+	string_t normalized = normalize_always(s, form);
+	if (normalized == s) {
+		return false;
+	}
+
+	s = std::move(normalized);
+	return true;
+}
+
+const char* Unicode::to_string(NormalizationForm x) {
+	using X = NormalizationForm;
+	switch (x) {
+		case X::NFC:  return "NFC";
+		case X::NFD:  return "NFD";
+		case X::NFKC: return "NFKC";
+		case X::NFKD: return "NFKD";
+		default: return "?";
+	}
+}
+
+const char* Unicode::to_string(QuickCheck x) {
+	using X = QuickCheck;
+	switch (x) {
+		case X::Yes:   return "Yes";
+		case X::No:    return "No";
+		case X::Maybe: return "Maybe";
+		default: return "?";
+	}
+}
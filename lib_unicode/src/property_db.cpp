@@ -0,0 +1,200 @@
+#include "unicode_property_db.hpp"
+
+#include <stdexcept>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Unicode::codepoint_t;
+using Unicode::PropertyDatabase;
+
+namespace {
+	uint64_t fnv1a_64(const uint8_t* data, size_t len) {
+		uint64_t ret = 0xcbf29ce484222325;
+		for (size_t i = 0; i < len; i++) {
+			ret ^= data[i];
+			ret *= 0x100000001b3;
+		}
+		return ret;
+	}
+}
+
+std::unique_ptr<PropertyDatabase> PropertyDatabase::open(
+		const std::string& path,
+		bool verify_checksum) {
+
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		throw std::runtime_error("cannot open property database " + path);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw std::runtime_error("cannot stat property database " + path);
+	}
+
+	const size_t map_len = st.st_size;
+	if (map_len < sizeof(Header)) {
+		close(fd);
+		throw std::runtime_error("property database is too short: " + path);
+	}
+
+	void* map = mmap(nullptr, map_len, PROT_READ, MAP_SHARED, fd, 0);
+
+	// the mapping keeps its own reference to the file
+	close(fd);
+
+	if (map == MAP_FAILED) {
+		throw std::runtime_error("cannot map property database " + path);
+	}
+
+	// the constructor takes ownership of the mapping, and validates it
+	std::unique_ptr<PropertyDatabase> ret(new PropertyDatabase(map, map_len));
+
+	if (verify_checksum) {
+		const Header* header = static_cast<const Header*>(map);
+		const uint8_t* body = static_cast<const uint8_t*>(map) + sizeof(Header);
+		if (fnv1a_64(body, header->body_size) != header->checksum) {
+			throw std::runtime_error("property database checksum mismatch: " + path);
+		}
+	}
+
+	return ret;
+}
+
+PropertyDatabase::PropertyDatabase(const void* map, size_t map_len) :
+	map(map), map_len(map_len) {
+
+	const Header* header = static_cast<const Header*>(map);
+	const uint8_t* base = static_cast<const uint8_t*>(map);
+
+	// anything thrown from here on would skip the destructor
+	auto fail = [&](const char* what) {
+		munmap(const_cast<void*>(map), map_len);
+		throw std::runtime_error(std::string("invalid property database: ") + what);
+	};
+
+	if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+		fail("bad magic");
+	}
+
+	if (header->format_version != FORMAT_VERSION) {
+		fail("unsupported format version");
+	}
+
+	// The offsets and sizes come from the file, so the checks subtract
+	// from what is known to fit instead of adding, which could wrap.
+	if (map_len < sizeof(Header) || header->body_size > map_len - sizeof(Header)) {
+		fail("truncated");
+	}
+
+	const uint64_t directory_len = uint64_t(header->table_count) * sizeof(TableEntry);
+	if (directory_len > header->body_size) {
+		fail("truncated directory");
+	}
+
+	const TableEntry* entries = reinterpret_cast<const TableEntry*>(base + sizeof(Header));
+
+	for (uint32_t i = 0; i < header->table_count; i++) {
+		const TableEntry& e = entries[i];
+
+		// unknown tables are from a newer writer, and can be skipped
+		if (e.id >= static_cast<uint32_t>(Table::COUNT)) continue;
+
+		if ((e.elem_size != 1 && e.elem_size != 8) || e.chunk_len == 0) {
+			fail("bad table entry");
+		}
+
+		const uint64_t index_len = uint64_t(e.chunk_count) * sizeof(uint32_t);
+		if (e.index_offset % alignof(uint32_t) != 0
+				|| e.data_offset % 8 != 0
+				|| e.index_offset > map_len
+				|| index_len > map_len - e.index_offset
+				|| e.data_offset > map_len) {
+			fail("table out of bounds");
+		}
+
+		MappedTable& t = tables[e.id];
+		t.index = reinterpret_cast<const uint32_t*>(base + e.index_offset);
+		t.data = base + e.data_offset;
+		t.elem_size = e.elem_size;
+		t.chunk_len = e.chunk_len;
+		t.chunk_count = e.chunk_count;
+		t.out_of_bounds_value = e.out_of_bounds_value;
+
+		// every chunk the index refers to has to be inside the file
+		const uint64_t chunk_bytes = uint64_t(e.chunk_len) * e.elem_size;
+		const uint64_t max_chunks = (map_len - e.data_offset) / chunk_bytes;
+		for (uint32_t j = 0; j < e.chunk_count; j++) {
+			if (uint64_t(t.index[j]) + 1 > max_chunks) {
+				fail("chunk out of bounds");
+			}
+		}
+	}
+
+	for (const MappedTable& t : tables) {
+		if (t.index == nullptr) {
+			fail("missing table");
+		}
+	}
+}
+
+PropertyDatabase::~PropertyDatabase() {
+	munmap(const_cast<void*>(map), map_len);
+}
+
+uint64_t PropertyDatabase::lookup(Table table, codepoint_t x) const {
+	const MappedTable& t = tables[static_cast<size_t>(table)];
+
+	const size_t chunk_index = x / t.chunk_len;
+	if (chunk_index >= t.chunk_count) {
+		return t.out_of_bounds_value;
+	}
+
+	const size_t i = size_t(t.index[chunk_index]) * t.chunk_len + x % t.chunk_len;
+
+	if (t.elem_size == 1) {
+		return t.data[i];
+	}
+
+	return reinterpret_cast<const uint64_t*>(t.data)[i];
+}
+
+std::string PropertyDatabase::get_unicode_version() const {
+	const Header* header = static_cast<const Header*>(map);
+	return std::string(
+			header->unicode_version,
+			strnlen(header->unicode_version, sizeof(header->unicode_version)));
+}
+
+Unicode::GeneralCategory PropertyDatabase::get_general_category(codepoint_t x) const {
+	return static_cast<GeneralCategory>(lookup(Table::GeneralCategory, x));
+}
+
+uint64_t PropertyDatabase::get_simple_properties(codepoint_t x) const {
+	return lookup(Table::SimpleProperties, x);
+}
+
+Unicode::EastAsianWidth PropertyDatabase::get_east_asian_width(codepoint_t x) const {
+	return static_cast<EastAsianWidth>(lookup(Table::EastAsianWidth, x));
+}
+
+Unicode::LineBreak PropertyDatabase::get_line_break(codepoint_t x) const {
+	return static_cast<LineBreak>(lookup(Table::LineBreak, x));
+}
+
+Unicode::Script PropertyDatabase::get_script(codepoint_t x) const {
+	return static_cast<Script>(lookup(Table::Script, x));
+}
+
+uint8_t PropertyDatabase::get_display_width(codepoint_t x, AmbiguousWidth ambiguous) const {
+	const uint8_t ret = lookup(Table::DisplayWidth, x);
+	if (ret == DISPLAY_WIDTH_AMBIGUOUS) {
+		return ambiguous == AmbiguousWidth::Wide ? 2 : 1;
+	}
+	return ret;
+}
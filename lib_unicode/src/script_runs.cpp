@@ -0,0 +1,92 @@
+#include "unicode_script_runs.hpp"
+
+using Unicode::codepoint_t;
+using Unicode::Script;
+using Unicode::ScriptSet;
+
+namespace {
+	// codepoints per bulk lookup
+	constexpr size_t BLOCK_LEN = 64;
+
+	// the extensions of codepoints that go with any script
+	constexpr ScriptSet COMMON = ScriptSet::of(Script::Common);
+	constexpr ScriptSet INHERITED = ScriptSet::of(Script::Inherited);
+}
+
+Script ScriptSet::first() const {
+	for (size_t i = 0; i < WORDS; i++) {
+		if (words[i] == 0) continue;
+		for (size_t j = 0; j < 64; j++) {
+			if ((words[i] >> j) & 1) {
+				return static_cast<Script>(i * 64 + j);
+			}
+		}
+	}
+	return Script::Unknown;
+}
+
+size_t ScriptSet::size() const {
+	size_t ret = 0;
+	for (size_t i = 0; i < WORDS; i++) {
+		for (uint64_t x = words[i]; x != 0; x &= x - 1) {
+			ret++;
+		}
+	}
+	return ret;
+}
+
+size_t Unicode::get_script_runs(
+		const codepoint_t* s, size_t len,
+		ScriptRun* out, size_t out_len) {
+
+	if (len == 0) return 0;
+
+	// the number of runs so far, which may run past out_len
+	size_t ret = 0;
+
+	// the current run, and the scripts it could still be written in.
+	// Until the first codepoint that narrows it down, that is any.
+	size_t begin = 0;
+	ScriptSet candidates = COMMON;
+	bool any = true;
+
+	ScriptSet extensions[BLOCK_LEN];
+
+	for (size_t i = 0; i < len; i += BLOCK_LEN) {
+		const size_t n = len - i < BLOCK_LEN ? len - i : BLOCK_LEN;
+		get_script_extensions(s + i, n, extensions);
+
+		for (size_t j = 0; j < n; j++) {
+			const ScriptSet& x = extensions[j];
+			if (x == COMMON || x == INHERITED) continue;
+
+			if (any) {
+				candidates = x;
+				any = false;
+				continue;
+			}
+
+			const ScriptSet narrowed = candidates & x;
+			if (!narrowed.empty()) {
+				candidates = narrowed;
+				continue;
+			}
+
+			// nothing in common, so the run ends here
+			if (ret < out_len) {
+				out[ret] = ScriptRun{ begin, i + j, candidates.first() };
+			}
+			ret++;
+
+			begin = i + j;
+			candidates = x;
+		}
+	}
+
+	if (ret < out_len) {
+		out[ret] = ScriptRun{ begin, len, candidates.first() };
+	}
+	ret++;
+
+	return ret;
+}
@@ -0,0 +1,80 @@
+#include "unicode_search.hpp"
+
+#include <algorithm>
+
+using Unicode::codepoint_t;
+
+// codepoints per ASCII block
+constexpr size_t BLOCK_LEN = 16;
+
+size_t Unicode::fold_for_search(
+		const codepoint_t* s, size_t len,
+		codepoint_t* out, size_t out_len) {
+
+	// the length of the folding so far, which may run past out_len
+	size_t ret = 0;
+
+	size_t i = 0;
+	while (i < len) {
+		// Whole blocks of ASCII only need lowercasing. The loops are
+		// branchless, so they are left for the compiler to vectorize.
+		while (i + BLOCK_LEN <= len && ret + BLOCK_LEN <= out_len) {
+			codepoint_t any = 0;
+			for (size_t j = 0; j < BLOCK_LEN; j++) {
+				any |= s[i + j];
+			}
+			if (any >= 0x80) break;
+
+			for (size_t j = 0; j < BLOCK_LEN; j++) {
+				const codepoint_t c = s[i + j];
+				out[ret + j] = c + (codepoint_t(c - 'A' < 26) << 5);
+			}
+
+			i += BLOCK_LEN;
+			ret += BLOCK_LEN;
+		}
+
+		if (i == len) break;
+
+		// a codepoint at a time, until the next block
+		const size_t end = std::min(len, i + BLOCK_LEN);
+		for (; i < end; i++) {
+			const codepoint_t c = s[i];
+
+			if (c < 0x80) {
+				if (ret < out_len) {
+					out[ret] = c + (codepoint_t(c - 'A' < 26) << 5);
+				}
+				ret++;
+				continue;
+			}
+
+			codepoint_t folded[MAX_SEARCH_FOLDING_LEN];
+			const size_t n = get_search_folding(c, folded);
+
+			for (size_t j = 0; j < n; j++, ret++) {
+				if (ret < out_len) {
+					out[ret] = folded[j];
+				}
+			}
+		}
+	}
+
+	return ret;
+}
+
+Unicode::string_t Unicode::fold_for_search(const string_t& s) {
+	// folding rarely makes text longer, so try with the same length first
+	string_t ret(s.size(), 0);
+
+	const size_t len = fold_for_search(s.data(), s.size(), &ret[0], ret.size());
+
+	if (len > ret.size()) {
+		ret.resize(len);
+		fold_for_search(s.data(), s.size(), &ret[0], ret.size());
+	} else {
+		ret.resize(len);
+	}
+
+	return ret;
+}
@@ -0,0 +1,107 @@
+#include "unicode.hpp"
+
+using Unicode::codepoint_t;
+using Unicode::GraphemeClusterBreak;
+
+namespace {
+
+	// where we are in an emoji ZWJ sequence, for GB11
+	enum class PictState : uint8_t {
+		None,
+		Pict,    // \p{Extended_Pictographic} Extend*
+		PictZWJ  // \p{Extended_Pictographic} Extend* ZWJ
+	};
+
+	inline bool is_control(GraphemeClusterBreak x) {
+		using X = GraphemeClusterBreak;
+		return x == X::Control || x == X::CR || x == X::LF;
+	}
+
+	// true if there is no boundary between prev and next
+	inline bool is_joined(
+			GraphemeClusterBreak prev,
+			GraphemeClusterBreak next,
+			PictState pict_state,
+			bool next_is_pict,
+			size_t ri_count) {
+
+		using X = GraphemeClusterBreak;
+
+		// GB3
+		if (prev == X::CR && next == X::LF) return true;
+
+		// GB4, GB5
+		if (is_control(prev) || is_control(next)) return false;
+
+		// GB6
+		if (prev == X::L
+				&& (next == X::L || next == X::V || next == X::LV || next == X::LVT)) {
+			return true;
+		}
+
+		// GB7
+		if ((prev == X::LV || prev == X::V) && (next == X::V || next == X::T)) {
+			return true;
+		}
+
+		// GB8
+		if ((prev == X::LVT || prev == X::T) && next == X::T) return true;
+
+		// GB9, GB9a
+		if (next == X::Extend || next == X::ZWJ || next == X::SpacingMark) return true;
+
+		// GB9b
+		if (prev == X::Prepend) return true;
+
+		// GB11
+		if (pict_state == PictState::PictZWJ && next_is_pict) return true;
+
+		// GB12, GB13
+		if (prev == X::Regional_Indicator && next == X::Regional_Indicator) {
+			return ri_count % 2 == 1;
+		}
+
+		// GB999
+		return false;
+	}
+
+}
+
+size_t Unicode::next_grapheme_cluster_break(const codepoint_t* s, size_t len, size_t pos) {
+	using X = GraphemeClusterBreak;
+
+	if (pos >= len) return len;
+
+	GraphemeClusterBreak prev = get_grapheme_cluster_break(s[pos]);
+	PictState pict_state = is_extended_pictographic(s[pos])
+		? PictState::Pict
+		: PictState::None;
+	size_t ri_count = prev == X::Regional_Indicator ? 1 : 0;
+
+	for (size_t i = pos + 1; i < len; i++) {
+		const GraphemeClusterBreak next = get_grapheme_cluster_break(s[i]);
+		const bool next_is_pict = is_extended_pictographic(s[i]);
+
+		if (!is_joined(prev, next, pict_state, next_is_pict, ri_count)) {
+			return i;
+		}
+
+		if (next_is_pict) {
+			pict_state = PictState::Pict;
+		} else if (pict_state != PictState::Pict) {
+			pict_state = PictState::None;
+		} else if (next == X::ZWJ) {
+			pict_state = PictState::PictZWJ;
+		} else if (next != X::Extend) {
+			pict_state = PictState::None;
+		}
+
+		if (next == X::Regional_Indicator) {
+			ri_count++;
+		}
+
+		prev = next;
+	}
+
+	return len;
+}
@@ -555,6 +555,15 @@ const char* Unicode::to_string(Unicode::EastAsianWidth x) {
 	}
 };
 
+const char* Unicode::to_string(Unicode::AmbiguousWidth x) {
+	using X = Unicode::AmbiguousWidth;
+	switch (x) {
+		case X::Narrow: return "Narrow";
+		case X::Wide:   return "Wide";
+		default: return "?";
+	}
+};
+
 const char* Unicode::to_string(Unicode::GraphemeClusterBreak x) {
 	using X = Unicode::GraphemeClusterBreak;
 	switch (x) {
@@ -652,6 +661,36 @@ const char* Unicode::to_string(Unicode::LineBreak x) {
 	}
 }
 
+const char* Unicode::to_string(Unicode::BidiClass x) {
+	using X = Unicode::BidiClass;
+	switch (x) {
+		case X::L:   return "L";
+		case X::R:   return "R";
+		case X::AL:  return "AL";
+		case X::EN:  return "EN";
+		case X::ES:  return "ES";
+		case X::ET:  return "ET";
+		case X::AN:  return "AN";
+		case X::CS:  return "CS";
+		case X::NSM: return "NSM";
+		case X::BN:  return "BN";
+		case X::B:   return "B";
+		case X::S:   return "S";
+		case X::WS:  return "WS";
+		case X::ON:  return "ON";
+		case X::LRE: return "LRE";
+		case X::LRO: return "LRO";
+		case X::RLE: return "RLE";
+		case X::RLO: return "RLO";
+		case X::PDF: return "PDF";
+		case X::LRI: return "LRI";
+		case X::RLI: return "RLI";
+		case X::FSI: return "FSI";
+		case X::PDI: return "PDI";
+		default: return "??";
+	}
+}
+
 const char* Unicode::to_string(Unicode::Script x) {
 	using X = Unicode::Script;
 	switch(x) {
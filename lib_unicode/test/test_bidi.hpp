@@ -0,0 +1,174 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_bidi.hpp"
+
+#include <vector>
+
+class BidiTestSuite : public CxxTest::TestSuite {
+	public:
+		void check_levels(
+				const Unicode::string_t& s,
+				Unicode::BidiDirection direction,
+				const std::vector<Unicode::bidi_level_t>& expected) {
+
+			const Unicode::BidiParagraph paragraph(s, direction);
+			TS_ASSERT_EQUALS(paragraph.size(), expected.size());
+
+			for (size_t i = 0; i < expected.size(); i++) {
+				if (paragraph.get_level(i) != expected[i]) {
+					TS_FAIL("incorrect level at " + std::to_string(i));
+				}
+			}
+		}
+
+		void check_visual(
+				const Unicode::string_t& s,
+				const Unicode::string_t& expected,
+				Unicode::BidiDirection direction = Unicode::BidiDirection::Auto) {
+
+			if (Unicode::reorder_visually(s, direction) != expected) {
+				TS_FAIL("incorrect visual order");
+			}
+		}
+
+		void test_brackets_and_mirroring(void) {
+			TS_ASSERT_EQUALS(Unicode::get_bidi_bracket_type('('), Unicode::BidiBracketType::Open);
+			TS_ASSERT_EQUALS(Unicode::get_bidi_bracket_type(']'), Unicode::BidiBracketType::Close);
+			TS_ASSERT_EQUALS(Unicode::get_bidi_bracket_type('a'), Unicode::BidiBracketType::None);
+			TS_ASSERT_EQUALS(Unicode::get_bidi_paired_bracket('{'), U'}');
+			TS_ASSERT_EQUALS(Unicode::get_bidi_paired_bracket('a'), U'a');
+
+			// canonically equivalent brackets pair up
+			TS_ASSERT_EQUALS(
+					Unicode::get_bidi_bracket_pair_id(0x2329),
+					Unicode::get_bidi_bracket_pair_id(0x3009));
+			TS_ASSERT_DIFFERS(
+					Unicode::get_bidi_bracket_pair_id('('),
+					Unicode::get_bidi_bracket_pair_id('['));
+
+			TS_ASSERT_EQUALS(Unicode::get_bidi_mirroring_glyph('('), U')');
+			TS_ASSERT_EQUALS(Unicode::get_bidi_mirroring_glyph('<'), U'>');
+			TS_ASSERT_EQUALS(Unicode::get_bidi_mirroring_glyph('a'), U'a');
+		}
+
+		void test_paragraph_level(void) {
+			const Unicode::string_t ltr = U"123 abc \u05D0";
+			const Unicode::string_t rtl = U"123 \u05D0 abc";
+			const Unicode::string_t isolated = U"\u2067\u05D0\u2069 abc";
+			const Unicode::string_t neutral = U"123 !";
+
+			TS_ASSERT_EQUALS(Unicode::get_paragraph_level(ltr.data(), ltr.size()), 0);
+			TS_ASSERT_EQUALS(Unicode::get_paragraph_level(rtl.data(), rtl.size()), 1);
+			TS_ASSERT_EQUALS(Unicode::get_paragraph_level(isolated.data(), isolated.size()), 0);
+			TS_ASSERT_EQUALS(Unicode::get_paragraph_level(neutral.data(), neutral.size()), 0);
+		}
+
+		void test_quick_exit(void) {
+			const Unicode::string_t ltr = U"The quick brown fox, 123 (\u00E9)";
+			const Unicode::string_t rtl = U"abc \u05D0";
+			const Unicode::string_t arabic_number = U"abc \u0661";
+			const Unicode::string_t embedding = U"abc \u202Adef\u202C";
+
+			TS_ASSERT(!Unicode::needs_bidi(ltr.data(), ltr.size()));
+			TS_ASSERT(Unicode::needs_bidi(rtl.data(), rtl.size()));
+			TS_ASSERT(Unicode::needs_bidi(arabic_number.data(), arabic_number.size()));
+			TS_ASSERT(Unicode::needs_bidi(embedding.data(), embedding.size()));
+
+			TS_ASSERT(Unicode::BidiParagraph(ltr).is_ltr());
+			TS_ASSERT(!Unicode::BidiParagraph(rtl).is_ltr());
+			TS_ASSERT(!Unicode::BidiParagraph(ltr, Unicode::BidiDirection::RTL).is_ltr());
+			TS_ASSERT(Unicode::BidiParagraph().is_ltr());
+		}
+
+		void test_levels(void) {
+			using Unicode::BidiDirection;
+
+			// numbers in RTL text go up a level
+			check_levels(U"\u05D0 12 \u05D1", BidiDirection::Auto, { 1, 1, 2, 2, 1, 1 });
+
+			// and RTL text in LTR text goes up one
+			check_levels(U"ab \u05D0\u05D1 c", BidiDirection::Auto, { 0, 0, 0, 1, 1, 0, 0 });
+
+			// W2, European digits after Arabic letters are Arabic numbers
+			check_levels(U"\u0627 12", BidiDirection::Auto, { 1, 1, 2, 2 });
+
+			// L1, trailing whitespace goes back to the paragraph level
+			check_levels(U"\u05D0\u05D1  ", BidiDirection::LTR, { 1, 1, 0, 0 });
+			check_levels(U"ab  ", BidiDirection::RTL, { 2, 2, 1, 1 });
+		}
+
+		void test_explicit_formatting(void) {
+			using Unicode::BidiDirection;
+
+			// RLO ... PDF
+			check_levels(U"x\u202Eab\u202Cy", BidiDirection::Auto, { 0, 0, 1, 1, 1, 0 });
+
+			// RLI ... PDI, the isolate initiator and PDI stay at the outer level
+			check_levels(U"x\u2067ab\u2069y", BidiDirection::Auto, { 0, 0, 2, 2, 0, 0 });
+
+			// FSI looks at the first strong character inside
+			check_levels(U"x\u2068\u05D0b\u2069y", BidiDirection::Auto, { 0, 0, 1, 2, 0, 0 });
+		}
+
+		void test_reordering(void) {
+			using Unicode::BidiDirection;
+
+			check_visual(U"abc", U"abc");
+			check_visual(U"\u05D0\u05D1\u05D2", U"\u05D2\u05D1\u05D0");
+			check_visual(U"abc \u05D0\u05D1 def", U"abc \u05D1\u05D0 def");
+			check_visual(U"\u05D0 123 \u05D1", U"\u05D1 123 \u05D0");
+			check_visual(U"\u0627\u0644 \u0661\u0662", U"\u0661\u0662 \u0644\u0627");
+
+			// forced directions
+			check_visual(U"abc def", U"abc def", BidiDirection::RTL);
+			check_visual(U"\u05D0 abc", U"\u05D0 abc", BidiDirection::LTR);
+			check_visual(U"abc \u05D0", U"\u05D0 abc", BidiDirection::RTL);
+
+			// explicit formatting is dropped
+			check_visual(U"x\u202Eabc\u202Cy", U"xcbay");
+		}
+
+		void test_brackets(void) {
+			// brackets at odd levels are mirrored
+			check_visual(U"\u05D0(\u05D1)", U"(\u05D1)\u05D0");
+			check_visual(U"\u05D0 (abc) \u05D1", U"\u05D1 (abc) \u05D0");
+
+			// N0, brackets around the embedding direction take it, even with
+			// the other direction around them
+			check_visual(U"\u05D0 (a\u05D1) b", U"b (\u05D1a) \u05D0");
+			check_visual(U"a [\u05D0 b] \u05D1", U"a [\u05D0 b] \u05D1", Unicode::BidiDirection::LTR);
+
+			// N0 for brackets with only the opposite direction inside
+			check_visual(U"a (\u05D0\u05D1)", U"a (\u05D1\u05D0)");
+			check_visual(U"\u05D0 (ab)", U"(ab) \u05D0");
+		}
+
+		void test_combining_marks(void) {
+			// the vowel point stays after its letter
+			check_visual(U"\u05D0\u05B8\u05D1", U"\u05D1\u05D0\u05B8");
+		}
+
+		void test_visual_order(void) {
+			const Unicode::string_t s = U"ab \u05D0\u05D1\u05D2 c";
+			const Unicode::BidiParagraph paragraph(s);
+
+			std::vector<size_t> order(s.size());
+			paragraph.get_visual_order(0, s.size(), order.data());
+			TS_ASSERT(order == (std::vector<size_t>{ 0, 1, 2, 5, 4, 3, 6, 7 }));
+
+			// only part of the line
+			order.resize(3);
+			paragraph.get_visual_order(2, 5, order.data());
+			TS_ASSERT(order == (std::vector<size_t>{ 2, 4, 3 }));
+		}
+
+		void test_cached_paragraph(void) {
+			const Unicode::string_t s = U"\u05E9\u05DC\u05D5\u05DD world";
+			const Unicode::BidiParagraph paragraph(s);
+
+			TS_ASSERT_EQUALS(paragraph.get_paragraph_level(), 1);
+			TS_ASSERT(Unicode::reorder_visually(s, paragraph) == Unicode::reorder_visually(s));
+			TS_ASSERT(Unicode::reorder_visually(s) == U"world \u05DD\u05D5\u05DC\u05E9");
+		}
+};
@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+
+#include <vector>
+
+class BulkLookupTestSuite : public CxxTest::TestSuite {
+	public:
+		// every codepoint, and a bit beyond
+		std::vector<Unicode::codepoint_t> all_codepoints() {
+			std::vector<Unicode::codepoint_t> ret;
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT + 0x100; x++) {
+				ret.push_back(x);
+			}
+			return ret;
+		}
+
+		template <typename T>
+		void check_span(
+				const std::vector<Unicode::codepoint_t>& s,
+				void (*bulk)(const Unicode::codepoint_t*, size_t, T*),
+				T (*single)(Unicode::codepoint_t),
+				const std::string& name) {
+
+			std::vector<T> out(s.size());
+			bulk(s.data(), s.size(), out.data());
+
+			for (size_t i = 0; i < s.size(); i++) {
+				if (out[i] != single(s[i])) {
+					TS_FAIL("bulk " + name + " differs for " + Unicode::to_string(s[i]));
+					return;
+				}
+			}
+		}
+
+		void test_spans(void) {
+			const auto s = all_codepoints();
+			check_span<Unicode::GeneralCategory>(s, Unicode::get_general_category, Unicode::get_general_category, "general category");
+			check_span<uint64_t>(s, Unicode::get_simple_properties, Unicode::get_simple_properties, "simple properties");
+			check_span<Unicode::EastAsianWidth>(s, Unicode::get_east_asian_width, Unicode::get_east_asian_width, "east asian width");
+			check_span<Unicode::LineBreak>(s, Unicode::get_line_break, Unicode::get_line_break, "line break");
+			check_span<Unicode::Script>(s, Unicode::get_script, Unicode::get_script, "script");
+		}
+
+		void test_unordered_span(void) {
+			const std::vector<Unicode::codepoint_t> s = {
+				0x10FFFF, 'a', 0x4E00, 0x300, 'a', 0xFFFFFFFF, 0x1F600 };
+			check_span<Unicode::GeneralCategory>(s, Unicode::get_general_category, Unicode::get_general_category, "general category");
+		}
+
+		void test_match_simple_properties(void) {
+			const Unicode::string_t s = U"a b\tc d\u3000e"
+				U"................................................................";
+
+			std::vector<uint64_t> mask(Unicode::get_match_mask_len(s.size()));
+			Unicode::match_simple_properties(
+					s.data(), s.size(),
+					Unicode::SimplePropertyFlags::WHITE_SPACE,
+					mask.data());
+
+			TS_ASSERT_EQUALS(mask.size(), 2u);
+			TS_ASSERT_EQUALS(mask[0], 0b10101010u);
+			TS_ASSERT_EQUALS(mask[1], 0u);
+		}
+
+		void test_match_general_categories(void) {
+			const auto s = all_codepoints();
+			const uint32_t categories =
+				Unicode::general_category_mask(Unicode::GeneralCategory::Lu)
+				| Unicode::general_category_mask(Unicode::GeneralCategory::Nd);
+
+			std::vector<uint64_t> mask(Unicode::get_match_mask_len(s.size()));
+			Unicode::match_general_categories(s.data(), s.size(), categories, mask.data());
+
+			for (size_t i = 0; i < s.size(); i++) {
+				const auto gc = Unicode::get_general_category(s[i]);
+				const bool expected = gc == Unicode::GeneralCategory::Lu
+					|| gc == Unicode::GeneralCategory::Nd;
+				const bool actual = (mask[i / 64] >> (i % 64)) & 1;
+				if (expected != actual) {
+					TS_FAIL("incorrect match for " + Unicode::to_string(s[i]));
+					return;
+				}
+			}
+		}
+};
@@ -0,0 +1,56 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+
+class CaseMappingStringTestSuite : public CxxTest::TestSuite {
+	public:
+		void test_ascii(void) {
+			TS_ASSERT(Unicode::to_lower(U"Hello, World!") == U"hello, world!");
+			TS_ASSERT(Unicode::to_upper(U"Hello, World!") == U"HELLO, WORLD!");
+			TS_ASSERT(Unicode::casefold(U"Hello, World!") == U"hello, world!");
+		}
+
+		void test_latin1(void) {
+			for (Unicode::codepoint_t x = 0; x <= 0xFF; x++) {
+				TS_ASSERT_EQUALS(Unicode::to_lower(x), Unicode::get_simple_lowercase(x));
+				TS_ASSERT_EQUALS(Unicode::to_upper(x), Unicode::get_simple_uppercase(x));
+				TS_ASSERT_EQUALS(Unicode::to_title(x), Unicode::get_simple_titlecase(x));
+				TS_ASSERT_EQUALS(Unicode::casefold(x), Unicode::get_simple_casefold(x));
+			}
+		}
+
+		void test_expansion(void) {
+			TS_ASSERT(Unicode::to_upper(U"straße") == U"STRASSE");
+			TS_ASSERT(Unicode::casefold(U"Straße") == U"strasse");
+			TS_ASSERT(Unicode::to_upper(U"ﬁ") == U"FI");
+		}
+
+		void test_final_sigma(void) {
+			TS_ASSERT(Unicode::to_lower(U"ΟΔΟΣ") == U"οδος");
+			TS_ASSERT(Unicode::to_lower(U"ΟΔΟΣ ΟΔΟΣ") == U"οδος οδος");
+			TS_ASSERT(Unicode::to_lower(U"Σ") == U"σ");
+
+			// İ expands, and is still what comes before the Σ
+			TS_ASSERT(Unicode::to_lower(U"İΣ") == U"i̇ς");
+			Unicode::string_t s = U"İΣ";
+			Unicode::to_lower_in_place(s);
+			TS_ASSERT(s == Unicode::to_lower(U"İΣ"));
+		}
+
+		void test_in_place(void) {
+			Unicode::string_t s = U"Größe ÀÉÎ";
+			Unicode::casefold_in_place(s);
+			TS_ASSERT(s == U"grösse àéî");
+
+			s = U"ÀÉÎ";
+			Unicode::to_lower_in_place(&s[0], s.size());
+			TS_ASSERT(s == U"àéî");
+		}
+
+		void test_equals_ignore_case(void) {
+			TS_ASSERT(Unicode::equals_ignore_case(U"STRASSE", U"straße"));
+			TS_ASSERT(Unicode::equals_ignore_case(U"ΌΣΟΣ", U"όσος"));
+			TS_ASSERT(!Unicode::equals_ignore_case(U"strass", U"straße"));
+			TS_ASSERT(!Unicode::equals_ignore_case(U"abc", U"abd"));
+		}
+};
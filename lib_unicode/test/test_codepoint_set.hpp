@@ -0,0 +1,103 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_codepoint_set.hpp"
+
+#include <vector>
+
+class CodepointSetTestSuite : public CxxTest::TestSuite {
+	public:
+		template <typename Pred>
+		void check(const Unicode::CodepointSet& set, Pred pred, const std::string& name) {
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT + 0x100; x++) {
+				if (set.contains(x) != pred(x)) {
+					TS_FAIL(name + " is incorrect for " + Unicode::to_string(x));
+					return;
+				}
+			}
+		}
+
+		void test_empty(void) {
+			const Unicode::CodepointSet set;
+			TS_ASSERT(set.empty());
+			TS_ASSERT_EQUALS(set.size(), 0u);
+			TS_ASSERT(!set.contains(0));
+			TS_ASSERT_EQUALS(~~set, set);
+			TS_ASSERT_EQUALS(~set, Unicode::CodepointSet::all());
+			TS_ASSERT_EQUALS(Unicode::to_string(set), "[]");
+		}
+
+		void test_initializer_list(void) {
+			const Unicode::CodepointSet set = { 'c', 'a', 'b', 'a', 'x', 0x10FFFF, 0x110000 };
+			TS_ASSERT_EQUALS(set.size(), 5u);
+			TS_ASSERT_EQUALS(set.get_range_count(), 3u);
+			TS_ASSERT_EQUALS(Unicode::to_string(set), "[U+0061..U+0063 U+0078 U+10FFFF]");
+			TS_ASSERT(set.contains('b'));
+			TS_ASSERT(!set.contains('d'));
+			TS_ASSERT(set.contains(0x10FFFF));
+			TS_ASSERT(!set.contains(0x110000));
+		}
+
+		void test_ranges(void) {
+			auto set = Unicode::CodepointSet::from_range(0xFFC0, 0x10040);
+			TS_ASSERT_EQUALS(set.size(), 0x81u);
+			check(set, [](Unicode::codepoint_t x) {
+				return x >= 0xFFC0 && x <= 0x10040;
+			}, "range");
+
+			set.add_range(0x10041, 0x10050);
+			set.add('a');
+			TS_ASSERT_EQUALS(Unicode::to_string(set), "[U+0061 U+FFC0..U+10050]");
+
+			TS_ASSERT(Unicode::CodepointSet::from_range(5, 4).empty());
+			TS_ASSERT_EQUALS(
+					Unicode::CodepointSet::from_range(0x10FFF0, 0xFFFFFFFF).size(),
+					0x10u);
+		}
+
+		void test_predicates(void) {
+			const auto alphabetic = Unicode::CodepointSet::from_predicate(Unicode::is_alphabetic);
+			const auto digits = Unicode::CodepointSet::from_predicate([](Unicode::codepoint_t x) {
+				return Unicode::get_general_category(x) == Unicode::GeneralCategory::Nd;
+			});
+			const auto white_space = Unicode::CodepointSet::from_predicate(Unicode::is_white_space);
+
+			check(alphabetic, Unicode::is_alphabetic, "alphabetic");
+			check(white_space, Unicode::is_white_space, "white space");
+
+			check(alphabetic | digits, [](Unicode::codepoint_t x) {
+				return Unicode::is_alphabetic(x)
+					|| Unicode::get_general_category(x) == Unicode::GeneralCategory::Nd;
+			}, "union");
+
+			check(alphabetic & ~white_space, [](Unicode::codepoint_t x) {
+				return Unicode::is_alphabetic(x) && !Unicode::is_white_space(x);
+			}, "intersection");
+
+			check(~alphabetic, [](Unicode::codepoint_t x) {
+				return x <= Unicode::MAX_CODEPOINT && !Unicode::is_alphabetic(x);
+			}, "complement");
+
+			check(alphabetic - Unicode::CodepointSet::from_range(0, 0x7F), [](Unicode::codepoint_t x) {
+				return x > 0x7F && Unicode::is_alphabetic(x);
+			}, "difference");
+
+			TS_ASSERT_EQUALS(~~alphabetic, alphabetic);
+			TS_ASSERT((alphabetic & ~alphabetic).empty());
+			TS_ASSERT_EQUALS(alphabetic | ~alphabetic, Unicode::CodepointSet::all());
+		}
+
+		void test_match(void) {
+			const Unicode::string_t s = U"a1 b2\u3000c3"
+				U"..............................................................";
+			const Unicode::CodepointSet set = Unicode::CodepointSet::from_range('0', '9')
+				| Unicode::CodepointSet{ 0x3000 };
+
+			std::vector<uint64_t> mask(Unicode::get_match_mask_len(s.size()));
+			set.match(s.data(), s.size(), mask.data());
+
+			TS_ASSERT_EQUALS(mask.size(), 2u);
+			TS_ASSERT_EQUALS(mask[0], 0b10110010u);
+			TS_ASSERT_EQUALS(mask[1], 0u);
+		}
+};
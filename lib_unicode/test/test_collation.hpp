@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_collation.hpp"
+
+#include <algorithm>
+#include <vector>
+
+class CollationTestSuite : public CxxTest::TestSuite {
+	public:
+		// every string has to sort before the next one
+		void check_order(const std::vector<Unicode::string_t>& v, Unicode::CollationStrength strength) {
+			for (size_t i = 0; i + 1 < v.size(); i++) {
+				if (Unicode::collate(v[i], v[i + 1], strength) >= 0) {
+					TS_FAIL("incorrect order at " + std::to_string(i));
+				}
+			}
+		}
+
+		void test_order(void) {
+			check_order({
+					U"a", U"A", U"\u00E1", U"\u00C1", U"ab", U"Ab", U"b", U"B" },
+					Unicode::CollationStrength::Tertiary);
+
+			check_order({
+					U"cote", U"cot\u00E9", U"c\u00F4te", U"c\u00F4t\u00E9" },
+					Unicode::CollationStrength::Tertiary);
+
+			check_order({
+					U"", U"1", U"10", U"9", U"a", U"\u00E6", U"z", U"\u03B1", U"\u0430", U"\u4E00" },
+					Unicode::CollationStrength::Tertiary);
+
+			check_order({
+					U"role", U"r\u00F4le", U"roles" },
+					Unicode::CollationStrength::Secondary);
+		}
+
+		void test_strength(void) {
+			using S = Unicode::CollationStrength;
+
+			TS_ASSERT_EQUALS(Unicode::collate(U"abc", U"ABC", S::Primary), 0);
+			TS_ASSERT_EQUALS(Unicode::collate(U"abc", U"ABC", S::Secondary), 0);
+			TS_ASSERT_LESS_THAN(Unicode::collate(U"abc", U"ABC", S::Tertiary), 0);
+
+			TS_ASSERT_EQUALS(Unicode::collate(U"resume", U"r\u00E9sum\u00E9", S::Primary), 0);
+			TS_ASSERT_LESS_THAN(Unicode::collate(U"resume", U"r\u00E9sum\u00E9", S::Secondary), 0);
+		}
+
+		void test_normalization(void) {
+			// precomposed and decomposed forms are the same
+			TS_ASSERT_EQUALS(Unicode::get_sort_key(U"\u00E9"), Unicode::get_sort_key(U"e\u0301"));
+			TS_ASSERT_EQUALS(Unicode::get_sort_key(U"\uAC00"), Unicode::get_sort_key(U"\u1100\u1161"));
+		}
+
+		void test_contractions(void) {
+			const Unicode::string_t short_i = U"\u0439";
+			const auto elements = Unicode::get_collation_elements(short_i.data(), short_i.size());
+			TS_ASSERT_EQUALS(elements.size(), 1u);
+
+			// the breve is not blocked by the dot below, so it still
+			// contracts with the letter
+			const Unicode::string_t s = U"\u0438\u0323\u0306";
+			const Unicode::string_t dot = U"\u0323";
+			auto expected = elements;
+			const auto dot_elements = Unicode::get_collation_elements(dot.data(), dot.size());
+			expected.insert(expected.end(), dot_elements.begin(), dot_elements.end());
+			TS_ASSERT(Unicode::get_collation_elements(s.data(), s.size()) == expected);
+		}
+
+		void test_implicit_weights(void) {
+			// unassigned codepoints sort after everything in the DUCET,
+			// and among themselves by codepoint
+			check_order({
+					U"\u4E00", U"\u4E01", U"\U00020000", U"\U000E0080", U"\U0010FFFD" },
+					Unicode::CollationStrength::Tertiary);
+		}
+
+		void test_sort_keys(void) {
+			std::vector<Unicode::string_t> v = {
+				U"zebra", U"\u00C9clair", U"apple", U"Apple", U"\u00E9clair", U"eclair", U"Zebra" };
+
+			std::vector<Unicode::string_t> by_key = v;
+			std::sort(by_key.begin(), by_key.end(), [](const auto& a, const auto& b) {
+				return Unicode::get_sort_key(a) < Unicode::get_sort_key(b);
+			});
+
+			const std::vector<Unicode::string_t> expected = {
+				U"apple", U"Apple", U"eclair", U"\u00E9clair", U"\u00C9clair", U"zebra", U"Zebra" };
+			TS_ASSERT(by_key == expected);
+		}
+};
@@ -0,0 +1,54 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_confusables.hpp"
+
+class ConfusablesTestSuite : public CxxTest::TestSuite {
+	public:
+		void test_prototypes(void) {
+			Unicode::codepoint_t out[Unicode::MAX_CONFUSABLE_PROTOTYPE_LEN];
+
+			TS_ASSERT_EQUALS(Unicode::get_confusable_prototype(0x0430, out), 1u);
+			TS_ASSERT_EQUALS(out[0], U'a');
+
+			TS_ASSERT_EQUALS(Unicode::get_confusable_prototype('m', out), 2u);
+			TS_ASSERT_EQUALS(out[0], U'r');
+			TS_ASSERT_EQUALS(out[1], U'n');
+
+			// not confusable with anything
+			TS_ASSERT_EQUALS(Unicode::get_confusable_prototype('a', out), 1u);
+			TS_ASSERT_EQUALS(out[0], U'a');
+
+			TS_ASSERT_EQUALS(Unicode::get_confusable_prototype(0xFDFA, out), 18u);
+		}
+
+		void test_skeleton(void) {
+			TS_ASSERT(Unicode::get_skeleton(U"") == U"");
+			TS_ASSERT(Unicode::get_skeleton(U"abc") == U"abc");
+			TS_ASSERT(Unicode::get_skeleton(U"\u0441\u043E\u0440\u0443") == U"copy");
+			TS_ASSERT(Unicode::get_skeleton(U"m") == U"rn");
+		}
+
+		void test_confusable(void) {
+			// Cyrillic and Greek homoglyphs
+			TS_ASSERT(Unicode::are_confusable(U"paypal", U"p\u0430yp\u0430l"));
+			TS_ASSERT(Unicode::are_confusable(U"Buy food", U"Buy f\u03BF\u043Ed"));
+			TS_ASSERT(Unicode::are_confusable(U"Alpha", U"\u0391lpha"));
+
+			// ASCII lookalikes, and fullwidth forms
+			TS_ASSERT(Unicode::are_confusable(U"modern", U"rnodern"));
+			TS_ASSERT(Unicode::are_confusable(U"Il1|", U"llll"));
+			TS_ASSERT(Unicode::are_confusable(U"a", U"\uFF41"));
+
+			// the same text, normalized differently, or with invisible
+			// characters in it
+			TS_ASSERT(Unicode::are_confusable(U"caf\u00E9", U"cafe\u0301"));
+			TS_ASSERT(Unicode::are_confusable(U"caf\u00E9", U"caf\u0435\u0341"));
+			TS_ASSERT(Unicode::are_confusable(U"todo", U"to\u200Bdo"));
+
+			// case is not ignored
+			TS_ASSERT(!Unicode::are_confusable(U"paypal", U"PayPal"));
+			TS_ASSERT(!Unicode::are_confusable(U"cafe", U"caf\u00E9"));
+			TS_ASSERT(!Unicode::are_confusable(U"Buy food", U"Buy foot"));
+		}
+};
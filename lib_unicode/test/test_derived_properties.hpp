@@ -0,0 +1,164 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+
+#include <functional>
+
+// The derived properties come straight from DerivedCoreProperties.txt. This
+// checks them against their definitions in terms of the other properties,
+// which is how they used to be computed.
+class DerivedPropertiesTestSuite : public CxxTest::TestSuite {
+	public:
+		using GC = Unicode::GeneralCategory;
+
+		void check(
+				std::function<bool(Unicode::codepoint_t)> generated,
+				std::function<bool(Unicode::codepoint_t)> composed,
+				const std::string& name) {
+
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT + 0x100; x++) {
+				if (generated(x) != composed(x)) {
+					TS_FAIL(name + " differs from its definition for " + Unicode::to_string(x));
+					return;
+				}
+			}
+		}
+
+		static bool composed_lowercase(Unicode::codepoint_t x) {
+			return Unicode::get_general_category(x) == GC::Ll
+				|| Unicode::is_other_lowercase(x);
+		}
+
+		static bool composed_uppercase(Unicode::codepoint_t x) {
+			return Unicode::get_general_category(x) == GC::Lu
+				|| Unicode::is_other_uppercase(x);
+		}
+
+		static bool composed_id_start(Unicode::codepoint_t x) {
+			const auto g = Unicode::get_general_category(x);
+			return (g == GC::Lu
+					|| g == GC::Ll
+					|| g == GC::Lt
+					|| g == GC::Lm
+					|| g == GC::Lo
+					|| g == GC::Nl
+					|| Unicode::is_other_id_start(x))
+				&& !Unicode::is_pattern_syntax(x)
+				&& !Unicode::is_pattern_white_space(x);
+		}
+
+		static bool composed_grapheme_extend(Unicode::codepoint_t x) {
+			const auto g = Unicode::get_general_category(x);
+			return g == GC::Me
+				|| g == GC::Mn
+				|| Unicode::is_other_grapheme_extend(x);
+		}
+
+		void test_math(void) {
+			check(Unicode::is_math, [](Unicode::codepoint_t x) {
+				return Unicode::get_general_category(x) == GC::Sm
+					|| Unicode::is_other_math(x);
+			}, "Math");
+		}
+
+		void test_alphabetic(void) {
+			check(Unicode::is_alphabetic, [](Unicode::codepoint_t x) {
+				const auto g = Unicode::get_general_category(x);
+				return composed_uppercase(x)
+					|| composed_lowercase(x)
+					|| g == GC::Lt
+					|| g == GC::Lm
+					|| g == GC::Lo
+					|| g == GC::Nl
+					|| Unicode::is_other_alphabetic(x);
+			}, "Alphabetic");
+		}
+
+		void test_case(void) {
+			check(Unicode::is_lowercase, composed_lowercase, "Lowercase");
+			check(Unicode::is_uppercase, composed_uppercase, "Uppercase");
+
+			// D135
+			check(Unicode::is_cased, [](Unicode::codepoint_t x) {
+				return composed_lowercase(x)
+					|| composed_uppercase(x)
+					|| Unicode::get_general_category(x) == GC::Lt;
+			}, "Cased");
+
+			// D136
+			check(Unicode::is_case_ignorable, [](Unicode::codepoint_t x) {
+				const auto g = Unicode::get_general_category(x);
+				if (g == GC::Mn
+						|| g == GC::Me
+						|| g == GC::Cf
+						|| g == GC::Lm
+						|| g == GC::Sk) {
+					return true;
+				}
+
+				const auto wb = Unicode::get_word_break(x);
+				return wb == Unicode::WordBreak::MidLetter
+					|| wb == Unicode::WordBreak::MidNumLet
+					|| wb == Unicode::WordBreak::Single_Quote;
+			}, "Case_Ignorable");
+		}
+
+		// UAX #31
+		void test_identifiers(void) {
+			check(Unicode::is_id_start, composed_id_start, "ID_Start");
+
+			check(Unicode::is_id_continue, [](Unicode::codepoint_t x) {
+				const auto g = Unicode::get_general_category(x);
+				return composed_id_start(x)
+					|| ((g == GC::Mn
+							|| g == GC::Mc
+							|| g == GC::Nd
+							|| g == GC::Pc
+							|| Unicode::is_other_id_continue(x))
+						&& !Unicode::is_pattern_syntax(x)
+						&& !Unicode::is_pattern_white_space(x));
+			}, "ID_Continue");
+
+			// XID_* are the NFKC closures, which only ever remove codepoints
+			const auto never = [](Unicode::codepoint_t) { return false; };
+			check([](Unicode::codepoint_t x) {
+				return Unicode::is_xid_start(x) && !Unicode::is_id_start(x);
+			}, never, "XID_Start");
+			check([](Unicode::codepoint_t x) {
+				return Unicode::is_xid_continue(x) && !Unicode::is_id_continue(x);
+			}, never, "XID_Continue");
+		}
+
+		void test_default_ignorable(void) {
+			check(Unicode::is_default_ignorable_code_point, [](Unicode::codepoint_t x) {
+				// the interlinear annotation and Egyptian hieroglyph format
+				// controls are visible
+				if ((x >= 0xFFF9 && x <= 0xFFFB) || (x >= 0x13430 && x <= 0x1343F)) {
+					return false;
+				}
+
+				return (Unicode::get_general_category(x) == GC::Cf
+						|| Unicode::is_variation_selector(x)
+						|| Unicode::is_other_default_ignorable_code_point(x))
+					&& !Unicode::is_white_space(x)
+					&& !Unicode::is_prepended_concatenation_mark(x);
+			}, "Default_Ignorable_Code_Point");
+		}
+
+		void test_graphemes(void) {
+			check(Unicode::is_grapheme_extend, composed_grapheme_extend, "Grapheme_Extend");
+
+			check(Unicode::is_grapheme_base, [](Unicode::codepoint_t x) {
+				const auto g = Unicode::get_general_category(x);
+				return x <= Unicode::MAX_CODEPOINT
+					&& g != GC::Cc
+					&& g != GC::Cf
+					&& g != GC::Cs
+					&& g != GC::Co
+					&& g != GC::Cn
+					&& g != GC::Zl
+					&& g != GC::Zp
+					&& !composed_grapheme_extend(x);
+			}, "Grapheme_Base");
+		}
+};
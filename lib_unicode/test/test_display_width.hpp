@@ -0,0 +1,75 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+
+#include <vector>
+
+class DisplayWidthTestSuite : public CxxTest::TestSuite {
+	public:
+		void check(
+				const Unicode::string_t &s,
+				size_t expected,
+				Unicode::AmbiguousWidth ambiguous = Unicode::AmbiguousWidth::Narrow) {
+
+			const size_t actual = Unicode::get_display_width(s, ambiguous);
+			if (actual != expected) {
+				std::string cps;
+				for (auto x : s) cps += Unicode::to_string(x) + " ";
+				TS_FAIL("incorrect width for " + cps
+						+ "expected " + std::to_string(expected)
+						+ ", got " + std::to_string(actual));
+			}
+		}
+
+		void check_clusters(const Unicode::string_t &s, std::vector<size_t> expected) {
+			std::vector<size_t> actual;
+			for (size_t i = 0; i < s.size(); ) {
+				i = Unicode::next_grapheme_cluster_break(s.data(), s.size(), i);
+				actual.push_back(i);
+			}
+			TS_ASSERT_EQUALS(actual, expected);
+		}
+
+		void test_ascii(void) {
+			check(U"", 0);
+			check(U"hello", 5);
+			check(U"a\tb", 2);
+		}
+
+		void test_wide(void) {
+			check(U"\u65E5\u672C", 4);
+			check(U"a\uFF21", 3); // FULLWIDTH LATIN CAPITAL LETTER A
+		}
+
+		void test_zero_width(void) {
+			check(U"e\u0301", 1); // combining acute
+			check(U"a\u200Bb", 2); // zero width space
+			check(U"a\u00ADb", 3); // soft hyphen is drawn
+			check(U"\u1100\u1161\u11A8", 2); // conjoining jamo
+		}
+
+		void test_ambiguous(void) {
+			check(U"\u00B1", 1);
+			check(U"\u00B1", 2, Unicode::AmbiguousWidth::Wide);
+			check(U"\u0391\u0392", 4, Unicode::AmbiguousWidth::Wide);
+		}
+
+		void test_emoji(void) {
+			check(U"\U0001F600", 2);
+			check(U"\u2764", 1);
+			check(U"\u2764\uFE0F", 2); // emoji presentation selector
+			check(U"\U0001F1FA\U0001F1F8", 2); // flag
+			check(U"\U0001F468\u200D\U0001F469\u200D\U0001F467", 2); // ZWJ sequence
+			check(U"\U0001F44B\U0001F3FD", 2); // skin tone modifier
+		}
+
+		void test_grapheme_clusters(void) {
+			check_clusters(U"ab", { 1, 2 });
+			check_clusters(U"\r\n", { 2 });
+			check_clusters(U"e\u0301x", { 2, 3 });
+			check_clusters(U"\U0001F1FA\U0001F1F8\U0001F1FA", { 2, 3 });
+			check_clusters(U"\U0001F468\u200D\U0001F469", { 3 });
+			check_clusters(U"a\u200D\U0001F469", { 2, 3 });
+			check_clusters(U"\u1100\u1161\u11A8\u1100", { 3, 4 });
+		}
+};
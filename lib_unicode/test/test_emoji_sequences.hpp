@@ -0,0 +1,70 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_emoji.hpp"
+
+class EmojiSequencesTestSuite : public CxxTest::TestSuite {
+	public:
+		void test_single_emoji(void) {
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\U0001F600"));
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\u2764\uFE0F"));
+
+			// text presentation by default, so only with VS16
+			TS_ASSERT(!Unicode::is_emoji_sequence(U"\u2764"));
+			TS_ASSERT(!Unicode::is_emoji_sequence(U"a"));
+			TS_ASSERT(!Unicode::is_emoji_sequence(U""));
+		}
+
+		void test_keycaps(void) {
+			TS_ASSERT(Unicode::is_emoji_sequence(U"1\uFE0F\u20E3"));
+			TS_ASSERT(Unicode::is_emoji_sequence(U"#\uFE0F\u20E3"));
+			TS_ASSERT(!Unicode::is_emoji_sequence(U"1\u20E3"));
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"1\uFE0F"), 0u);
+		}
+
+		void test_flags(void) {
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\U0001F1E9\U0001F1EA"));
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\U0001F3F4\U000E0067\U000E0062\U000E0065\U000E006E\U000E0067\U000E007F"));
+
+			// regional indicators only pair up into RGI flags
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"\U0001F1E9"), 0u);
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"\U0001F1E9\U0001F1E9"), 0u);
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"\U0001F1E9\U0001F1EA\U0001F1EF\U0001F1F5"), 2u);
+
+			// an incomplete tag sequence is just the black flag
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"\U0001F3F4\U000E0067\U000E0062"), 1u);
+		}
+
+		void test_modifiers(void) {
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\U0001F44D\U0001F3FD"));
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\u261D\U0001F3FB"));
+
+			// not a modifier base
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"\U0001F600\U0001F3FD"), 1u);
+		}
+
+		void test_zwj_sequences(void) {
+			const Unicode::string_t family = U"\U0001F468\u200D\U0001F469\u200D\U0001F467\u200D\U0001F466";
+			TS_ASSERT(Unicode::is_emoji_sequence(family));
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\U0001F468\U0001F3FB\u200D\u2695\uFE0F"));
+			TS_ASSERT(Unicode::is_emoji_sequence(U"\U0001F3F3\uFE0F\u200D\U0001F308"));
+
+			// the longest match, which is a shorter family here
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(family.data(), 5), 5u);
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(family.data(), 6), 5u);
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(family.data(), 3), 1u);
+
+			// and just the man, for a family that is not RGI
+			TS_ASSERT_EQUALS(Unicode::match_emoji_sequence(U"\U0001F468\u200D\U0001F408"), 1u);
+		}
+
+		void test_display_width(void) {
+			TS_ASSERT_EQUALS(Unicode::get_display_width(U"1\uFE0F\u20E3 go"), 5u);
+			TS_ASSERT_EQUALS(Unicode::get_display_width(U"\U0001F1E9\U0001F1EA\U0001F1EF\U0001F1F5"), 4u);
+			TS_ASSERT_EQUALS(Unicode::get_display_width(U"\U0001F3F4\U000E0067\U000E0062\U000E0065\U000E006E\U000E0067\U000E007F!"), 3u);
+			TS_ASSERT_EQUALS(Unicode::get_display_width(U"\U0001F468\u200D\U0001F469\u200D\U0001F467\u200D\U0001F466x"), 3u);
+
+			// a mark after a sequence still belongs to it
+			TS_ASSERT_EQUALS(Unicode::get_display_width(U"\U0001F600\u0301a"), 3u);
+		}
+};
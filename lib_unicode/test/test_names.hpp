@@ -0,0 +1,99 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_names.hpp"
+
+#include <vector>
+
+class NamesTestSuite : public CxxTest::TestSuite {
+	public:
+		void test_names(void) {
+			TS_ASSERT_EQUALS(Unicode::get_name(0x0041), "LATIN CAPITAL LETTER A");
+			TS_ASSERT_EQUALS(Unicode::get_name(0x00E9), "LATIN SMALL LETTER E WITH ACUTE");
+			TS_ASSERT_EQUALS(Unicode::get_name(0x1F600), "GRINNING FACE");
+			TS_ASSERT_EQUALS(Unicode::get_name(0xFDFA),
+					"ARABIC LIGATURE SALLALLAHOU ALAYHE WASALLAM");
+
+			// no names
+			TS_ASSERT_EQUALS(Unicode::get_name(0x0000), "");
+			TS_ASSERT_EQUALS(Unicode::get_name(0xE000), "");
+			TS_ASSERT_EQUALS(Unicode::get_name(0xD800), "");
+			TS_ASSERT_EQUALS(Unicode::get_name(0x10FFFF), "");
+		}
+
+		void test_derived_names(void) {
+			TS_ASSERT_EQUALS(Unicode::get_name(0x4E00), "CJK UNIFIED IDEOGRAPH-4E00");
+			TS_ASSERT_EQUALS(Unicode::get_name(0x20000), "CJK UNIFIED IDEOGRAPH-20000");
+			TS_ASSERT_EQUALS(Unicode::get_name(0x17000), "TANGUT IDEOGRAPH-17000");
+
+			TS_ASSERT_EQUALS(Unicode::get_name(0xAC00), "HANGUL SYLLABLE GA");
+			TS_ASSERT_EQUALS(Unicode::get_name(0xAC01), "HANGUL SYLLABLE GAG");
+			TS_ASSERT_EQUALS(Unicode::get_name(0xC544), "HANGUL SYLLABLE A");
+			TS_ASSERT_EQUALS(Unicode::get_name(0xD7A3), "HANGUL SYLLABLE HIH");
+		}
+
+		void test_to_string_with_name(void) {
+			TS_ASSERT_EQUALS(Unicode::to_string_with_name(0x0061), "U+0061 LATIN SMALL LETTER A");
+			TS_ASSERT_EQUALS(Unicode::to_string_with_name(0x000A), "U+000A");
+		}
+
+		void test_find_by_name(void) {
+			Unicode::codepoint_t x = 0;
+
+			TS_ASSERT(Unicode::find_by_name("LATIN SMALL LETTER A", &x));
+			TS_ASSERT_EQUALS(x, 0x0061u);
+
+			TS_ASSERT(Unicode::find_by_name("Latin Small Letter A With Acute", &x));
+			TS_ASSERT_EQUALS(x, 0x00E1u);
+
+			TS_ASSERT(Unicode::find_by_name("hangul syllable gag", &x));
+			TS_ASSERT_EQUALS(x, 0xAC01u);
+
+			TS_ASSERT(Unicode::find_by_name("CJK UNIFIED IDEOGRAPH-4E00", &x));
+			TS_ASSERT_EQUALS(x, 0x4E00u);
+
+			TS_ASSERT(!Unicode::find_by_name("", &x));
+			TS_ASSERT(!Unicode::find_by_name("LATIN SMALL LETTER", &x));
+			TS_ASSERT(!Unicode::find_by_name("NOT A NAME", &x));
+			TS_ASSERT(!Unicode::find_by_name("HANGUL SYLLABLE", &x));
+			TS_ASSERT(!Unicode::find_by_name("HANGUL SYLLABLE XYZ", &x));
+			TS_ASSERT(!Unicode::find_by_name("CJK UNIFIED IDEOGRAPH-04E00", &x));
+			TS_ASSERT(!Unicode::find_by_name("CJK UNIFIED IDEOGRAPH-0041", &x));
+		}
+
+		void test_round_trip(void) {
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT; x++) {
+				const std::string name = Unicode::get_name(x);
+				if (name.empty()) continue;
+
+				Unicode::codepoint_t found = 0;
+				if (!Unicode::find_by_name(name, &found) || found != x) {
+					TS_FAIL("name lookup failed for " + Unicode::to_string_with_name(x));
+					return;
+				}
+			}
+		}
+
+		void test_prefix_search(void) {
+			const std::string prefix = "LATIN SMALL LETTER A WITH";
+			const size_t count = Unicode::find_by_name_prefix(prefix, nullptr, 0);
+			TS_ASSERT(count > 10);
+
+			std::vector<Unicode::codepoint_t> found(count);
+			TS_ASSERT_EQUALS(Unicode::find_by_name_prefix("latin small letter a with", found.data(), found.size()), count);
+
+			std::string previous;
+			for (const Unicode::codepoint_t x : found) {
+				const std::string name = Unicode::get_name(x);
+				TS_ASSERT_EQUALS(name.compare(0, prefix.size(), prefix), 0);
+				TS_ASSERT(previous < name);
+				previous = name;
+			}
+
+			Unicode::codepoint_t first = 0;
+			TS_ASSERT_EQUALS(Unicode::find_by_name_prefix("GRINNING FACE", &first, 1), 4u);
+			TS_ASSERT_EQUALS(first, 0x1F600u);
+
+			TS_ASSERT_EQUALS(Unicode::find_by_name_prefix("ZZZ", nullptr, 0), 0u);
+		}
+};
@@ -0,0 +1,109 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_property_db.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+class PropertyDatabaseTestSuite : public CxxTest::TestSuite {
+	public:
+		// the build writes it next to the test runner
+		std::string get_path() {
+			const char* env = std::getenv("UNICODE_PROPERTY_DB");
+			return env != nullptr ? env : "bin/lib_unicode/unicode_properties.db";
+		}
+
+		void test_matches_compiled_tables(void) {
+			const auto db = Unicode::PropertyDatabase::open(get_path());
+
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT + 1; x++) {
+				if (db->get_general_category(x) != Unicode::get_general_category(x)
+						|| db->get_simple_properties(x) != Unicode::get_simple_properties(x)
+						|| db->get_east_asian_width(x) != Unicode::get_east_asian_width(x)
+						|| db->get_line_break(x) != Unicode::get_line_break(x)
+						|| db->get_script(x) != Unicode::get_script(x)
+						|| db->get_display_width(x) != Unicode::get_display_width(x)) {
+					TS_FAIL("property database differs for " + Unicode::to_string(x));
+					return;
+				}
+			}
+
+			TS_ASSERT(!db->get_unicode_version().empty());
+		}
+
+		void check_rejected(const std::vector<char>& contents) {
+			const std::string path = get_path() + ".bad";
+			{
+				std::ofstream out(path, std::ios::binary);
+				out.write(contents.data(), contents.size());
+			}
+			TS_ASSERT_THROWS(Unicode::PropertyDatabase::open(path), std::runtime_error);
+			std::remove(path.c_str());
+		}
+
+		void test_rejects_bad_files(void) {
+			TS_ASSERT_THROWS(
+					Unicode::PropertyDatabase::open("/nonexistent/unicode_properties.db"),
+					std::runtime_error);
+
+			std::ifstream in(get_path(), std::ios::binary);
+			std::vector<char> good(
+					(std::istreambuf_iterator<char>(in)),
+					std::istreambuf_iterator<char>());
+			TS_ASSERT(good.size() > sizeof(Unicode::PropertyDatabase::Header));
+
+			// too short
+			check_rejected(std::vector<char>(good.begin(), good.begin() + 8));
+
+			// truncated
+			check_rejected(std::vector<char>(good.begin(), good.begin() + good.size() / 2));
+
+			// wrong magic
+			std::vector<char> bad = good;
+			bad[0] = 'X';
+			check_rejected(bad);
+
+			// a flipped bit in the data
+			bad = good;
+			bad[bad.size() - 1] ^= 1;
+			check_rejected(bad);
+		}
+
+		void set_u64(std::vector<char>& contents, size_t offset, uint64_t value) {
+			std::memcpy(contents.data() + offset, &value, sizeof(value));
+		}
+
+		// sizes and offsets that only fit when adding to them wraps around
+		void test_rejects_forged_sizes(void) {
+			using Header = Unicode::PropertyDatabase::Header;
+			using TableEntry = Unicode::PropertyDatabase::TableEntry;
+
+			std::ifstream in(get_path(), std::ios::binary);
+			const std::vector<char> good(
+					(std::istreambuf_iterator<char>(in)),
+					std::istreambuf_iterator<char>());
+			TS_ASSERT(good.size() > sizeof(Header) + sizeof(TableEntry));
+
+			std::vector<char> bad = good;
+			set_u64(bad, offsetof(Header, body_size), UINT64_MAX - sizeof(Header) + 1);
+			check_rejected(bad);
+
+			bad = good;
+			set_u64(bad, offsetof(Header, body_size), UINT64_MAX);
+			check_rejected(bad);
+
+			bad = good;
+			set_u64(bad, sizeof(Header) + offsetof(TableEntry, index_offset), UINT64_MAX - 3);
+			check_rejected(bad);
+
+			bad = good;
+			set_u64(bad, sizeof(Header) + offsetof(TableEntry, data_offset), good.size() - 8);
+			check_rejected(bad);
+		}
+};
@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_script_runs.hpp"
+
+#include <vector>
+
+class ScriptRunsTestSuite : public CxxTest::TestSuite {
+	public:
+		std::vector<Unicode::ScriptRun> get_runs(const Unicode::string_t& s) {
+			std::vector<Unicode::ScriptRun> ret(s.size());
+			ret.resize(Unicode::get_script_runs(s.data(), s.size(), ret.data(), ret.size()));
+			return ret;
+		}
+
+		void check_run(const Unicode::ScriptRun& run, size_t begin, size_t end, Unicode::Script script) {
+			TS_ASSERT_EQUALS(run.begin, begin);
+			TS_ASSERT_EQUALS(run.end, end);
+			TS_ASSERT_EQUALS(run.script, script);
+		}
+
+		void test_script_extensions(void) {
+			using Unicode::Script;
+
+			TS_ASSERT(Unicode::get_script_extensions(U'a') == Unicode::ScriptSet::of(Script::Latin));
+			TS_ASSERT(Unicode::get_script_extensions(U' ') == Unicode::ScriptSet::of(Script::Common));
+
+			// ARABIC TATWEEL
+			const Unicode::ScriptSet tatweel = Unicode::get_script_extensions(0x0640);
+			TS_ASSERT(tatweel.contains(Script::Arabic));
+			TS_ASSERT(tatweel.contains(Script::Syriac));
+			TS_ASSERT(!tatweel.contains(Script::Common));
+			TS_ASSERT(!tatweel.contains(Script::Latin));
+			TS_ASSERT(tatweel.size() > 2);
+
+			// KATAKANA-HIRAGANA PROLONGED SOUND MARK
+			const Unicode::ScriptSet prolonged = Unicode::get_script_extensions(0x30FC);
+			TS_ASSERT(prolonged.contains(Script::Hiragana));
+			TS_ASSERT(prolonged.contains(Script::Katakana));
+			TS_ASSERT_EQUALS(prolonged.size(), 2u);
+			TS_ASSERT_EQUALS(prolonged.first(), Script::Hiragana);
+		}
+
+		void test_bulk_script_extensions(void) {
+			std::vector<Unicode::codepoint_t> s;
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT; x++) {
+				s.push_back(x);
+			}
+
+			std::vector<Unicode::ScriptSet> bulk(s.size());
+			Unicode::get_script_extensions(s.data(), s.size(), bulk.data());
+
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT; x++) {
+				const Unicode::ScriptSet single = Unicode::get_script_extensions(x);
+				if (bulk[x] != single || single.empty()) {
+					TS_FAIL("incorrect script extensions for " + Unicode::to_string(x));
+					return;
+				}
+			}
+		}
+
+		void test_empty(void) {
+			TS_ASSERT_EQUALS(Unicode::get_script_runs(nullptr, 0, nullptr, 0), 0u);
+		}
+
+		void test_single_script(void) {
+			auto runs = get_runs(U"The quick brown fox, 123!");
+			TS_ASSERT_EQUALS(runs.size(), 1u);
+			check_run(runs[0], 0, 25, Unicode::Script::Latin);
+
+			runs = get_runs(U"123 !?");
+			TS_ASSERT_EQUALS(runs.size(), 1u);
+			check_run(runs[0], 0, 6, Unicode::Script::Common);
+		}
+
+		void test_common_and_inherited(void) {
+			// leading Common joins the following run, the rest the preceding one
+			auto runs = get_runs(U"1. abc \u03B1\u03B2\u03B3!");
+			TS_ASSERT_EQUALS(runs.size(), 2u);
+			check_run(runs[0], 0, 7, Unicode::Script::Latin);
+			check_run(runs[1], 7, 11, Unicode::Script::Greek);
+
+			// combining marks
+			runs = get_runs(U"e\u0301\u03B1\u0301");
+			TS_ASSERT_EQUALS(runs.size(), 2u);
+			check_run(runs[0], 0, 2, Unicode::Script::Latin);
+			check_run(runs[1], 2, 4, Unicode::Script::Greek);
+		}
+
+		void test_extensions(void) {
+			// the tatweel is used with Arabic
+			auto runs = get_runs(U"\u0628\u0640\u0628 abc");
+			TS_ASSERT_EQUALS(runs.size(), 2u);
+			check_run(runs[0], 0, 4, Unicode::Script::Arabic);
+			check_run(runs[1], 4, 7, Unicode::Script::Latin);
+
+			// the prolonged sound mark goes with the katakana before it
+			runs = get_runs(U"\u30AB\u30FC\u3072");
+			TS_ASSERT_EQUALS(runs.size(), 2u);
+			check_run(runs[0], 0, 2, Unicode::Script::Katakana);
+			check_run(runs[1], 2, 3, Unicode::Script::Hiragana);
+		}
+
+		void test_buffer(void) {
+			const Unicode::string_t s = U"ab\u03B1\u03B2ab";
+			Unicode::ScriptRun out[2];
+
+			TS_ASSERT_EQUALS(Unicode::get_script_runs(s.data(), s.size(), out, 2), 3u);
+			check_run(out[0], 0, 2, Unicode::Script::Latin);
+			check_run(out[1], 2, 4, Unicode::Script::Greek);
+
+			TS_ASSERT_EQUALS(Unicode::get_script_runs(s.data(), s.size(), nullptr, 0), 3u);
+		}
+
+		void test_long(void) {
+			// crosses the bulk lookup blocks
+			Unicode::string_t s;
+			for (size_t i = 0; i < 100; i++) {
+				s += U"abc \u03B1\u03B2\u03B3 ";
+			}
+
+			auto runs = get_runs(s);
+			TS_ASSERT_EQUALS(runs.size(), 200u);
+			for (size_t i = 0; i < runs.size(); i++) {
+				check_run(runs[i], i * 4, (i + 1) * 4,
+						i % 2 == 0 ? Unicode::Script::Latin : Unicode::Script::Greek);
+			}
+		}
+};
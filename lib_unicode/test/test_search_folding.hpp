@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include "unicode.hpp"
+#include "unicode_search.hpp"
+
+#include <vector>
+
+class SearchFoldingTestSuite : public CxxTest::TestSuite {
+	public:
+		void check(const Unicode::string_t& s, const Unicode::string_t& expected) {
+			if (Unicode::fold_for_search(s) != expected) {
+				TS_FAIL("incorrect search folding");
+			}
+		}
+
+		void test_ascii(void) {
+			check(U"", U"");
+			check(U"Resume", U"resume");
+			check(U"The Quick Brown Fox Jumps Over The Lazy Dog @[`{ 0123456789",
+					U"the quick brown fox jumps over the lazy dog @[`{ 0123456789");
+		}
+
+		void test_accents(void) {
+			check(U"R\u00E9sum\u00E9", U"resume");
+			check(U"Re\u0301sume\u0301", U"resume");
+			check(U"\u00C5ngstr\u00F6m", U"angstrom");
+			check(U"\u0130stanbul", U"istanbul");
+			check(U"cr\u00E8me br\u00FBl\u00E9e", U"creme brulee");
+		}
+
+		void test_substitutions(void) {
+			check(U"Stra\u00DFe", U"strasse");
+			check(U"\u00C6sir", U"aesir");
+			check(U"\uFB01le", U"file");
+			check(U"\uFF32\uFF45\uFF53\uFF55\uFF4D\uFF45", U"resume");
+			check(U"don\u2019t", U"don't");
+			check(U"\u0141\u00F3d\u017A", U"lodz");
+		}
+
+		void test_buffer(void) {
+			const Unicode::string_t s = U"Stra\u00DFe";
+			Unicode::codepoint_t out[4] = { 0, 0, 0, 0 };
+
+			// too short, the rest is cut off but still counted
+			TS_ASSERT_EQUALS(Unicode::fold_for_search(s.data(), s.size(), out, 3), 7u);
+			TS_ASSERT_EQUALS(out[0], U's');
+			TS_ASSERT_EQUALS(out[2], U'r');
+			TS_ASSERT_EQUALS(out[3], 0u);
+
+			TS_ASSERT_EQUALS(Unicode::fold_for_search(s.data(), s.size(), nullptr, 0), 7u);
+		}
+
+		void test_blocks_match_codepoints(void) {
+			// long runs of ASCII go through the block path, everything else
+			// a codepoint at a time, and both have to agree
+			std::vector<Unicode::codepoint_t> s;
+			for (Unicode::codepoint_t x = 0; x <= Unicode::MAX_CODEPOINT; x++) {
+				s.push_back(x);
+				if (x % 0x100 == 0) {
+					for (Unicode::codepoint_t y = 0; y < 0x80; y++) {
+						s.push_back(y);
+					}
+				}
+			}
+
+			std::vector<Unicode::codepoint_t> expected;
+			for (const Unicode::codepoint_t x : s) {
+				Unicode::codepoint_t folded[Unicode::MAX_SEARCH_FOLDING_LEN];
+				const size_t n = Unicode::get_search_folding(x, folded);
+				expected.insert(expected.end(), folded, folded + n);
+			}
+
+			std::vector<Unicode::codepoint_t> actual(expected.size());
+			TS_ASSERT_EQUALS(
+					Unicode::fold_for_search(s.data(), s.size(), actual.data(), actual.size()),
+					expected.size());
+			TS_ASSERT(actual == expected);
+		}
+};
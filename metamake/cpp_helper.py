@@ -6,6 +6,11 @@ def eprint(*args, **kwargs):
     print(*args, file=sys.stderr, **kwargs)
 
 
+# Files that the build itself generates, so they can be #included before
+# they exist. They are not checked for #include statements of their own.
+generated_files = set()
+
+
 def extract_quoted_include(line):
     INCLUDE_DIRECTIVE="#include "
 
@@ -23,6 +28,9 @@ def extract_quoted_include(line):
 def read_quoted_includes(file_path):
     ret = set()
 
+    if file_path in generated_files:
+        return ret
+
     if not os.path.isfile(file_path):
         eprint(f"warning: {file_path} is not a file, or does not exist yet, so it cannot be checked for any #include statements")
         return ret
@@ -51,7 +59,7 @@ def find_included_files(file_path, include_dirs):
         for include_dir in actual_include_dirs:
             candidate = os.path.join(include_dir, quoted_include)
 
-            if os.path.isfile(candidate):
+            if os.path.isfile(candidate) or candidate in generated_files:
                 ret.add(candidate)
                 found_one = True
                 break
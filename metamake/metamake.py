@@ -181,8 +181,9 @@ class InclusionTracker:
 # that include this as a dependency will also have those public things
 class CxxProject:
 
-    def __init__(self, name, bin_dir, executable=False):
+    def __init__(self, name, bin_dir, executable=False, optimization="-Og"):
         self.name = name
+        self.optimization = optimization
         self.bin_dir = os.path.join(bin_dir, name)
         self.flag = "CxxProject_" + name
 
@@ -275,6 +276,18 @@ class CxxProject:
                     os.path.join(source_dir, file),
                     headers=headers)
 
+    # Compiles the sources of another project as part of this one, with the
+    # flags of this one, instead of linking the objects of that one
+    def add_sources_of(self, other):
+        for source_file in other.source_files:
+            self.add_source_file(
+                    source_file,
+                    headers=other.get_inclusions(source_file))
+        for include_dir in other.get_public_include_dirs():
+            self.add_include_dir(include_dir, public=False)
+        for link in other.get_all_links():
+            self.add_link(link)
+
     def add_cxxtest_suite(self, suite):
         self.cxxtest_suites.add(suite)
 
@@ -318,7 +331,7 @@ class CxxProject:
         cxx_i_flags_str = ' '.join(cxx_i_flags)
         cxx_l_flags_str = ' '.join(cxx_l_flags)
 
-        cxx = "$(CXX) -g -Og -Werror -Wall -std=c++17"
+        cxx = f"$(CXX) -g {self.optimization} -Werror -Wall -std=c++17"
 
         cxx_compile = f"{cxx} {cxx_i_flags_str}"
 
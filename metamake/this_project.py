@@ -1,4 +1,5 @@
 import os
+import cpp_helper
 from metamake import CxxProject, flatten
 
 def get_lib_unicode(makefile, home, bin_dir):
@@ -12,13 +13,39 @@ def get_lib_unicode(makefile, home, bin_dir):
     l.add_include_dir(home, "include")
 
     l.add_source_file(os.path.join(src, "unicode.cpp"))
+    l.add_source_file(os.path.join(src, "case_mapping.cpp"))
+    l.add_source_file(os.path.join(src, "normalization.cpp"))
+    l.add_source_file(os.path.join(src, "segmentation.cpp"))
+    l.add_source_file(os.path.join(src, "display_width.cpp"))
+    l.add_source_file(os.path.join(src, "bulk_lookup.cpp"))
+    l.add_source_file(os.path.join(src, "property_db.cpp"))
+    l.add_source_file(os.path.join(src, "codepoint_set.cpp"))
+    l.add_source_file(os.path.join(src, "collation.cpp"))
+    l.add_source_file(os.path.join(src, "search_folding.cpp"))
+    l.add_source_file(os.path.join(src, "script_runs.cpp"))
+    l.add_source_file(os.path.join(src, "bidi.cpp"))
+    l.add_source_file(os.path.join(src, "names.cpp"))
+    l.add_source_file(os.path.join(src, "confusables.cpp"))
 
     # Manual tests
     l.add_cxxtest_suite_dir(
             test,
-            "test_codepoint_to_string.hpp")
-
-    def add_codegen(generator, result, ucd_files):
+            "test_codepoint_to_string.hpp",
+            "test_case_mapping.hpp",
+            "test_display_width.hpp",
+            "test_bulk_lookup.hpp",
+            "test_property_db.hpp",
+            "test_derived_properties.hpp",
+            "test_codepoint_set.hpp",
+            "test_collation.hpp",
+            "test_search_folding.hpp",
+            "test_script_runs.hpp",
+            "test_bidi.hpp",
+            "test_names.hpp",
+            "test_confusables.hpp",
+            "test_emoji_sequences.hpp")
+
+    def add_codegen(generator, result, ucd_files, generators=[]):
         nonlocal makefile
 
         UCD_DIR = os.path.join(home, "ucd")
@@ -31,11 +58,12 @@ def get_lib_unicode(makefile, home, bin_dir):
                     [generator,
                         os.path.join(codegen, "ucd.py"),
                         os.path.join(codegen, "megatable.py")],
+                    [os.path.join(codegen, f"gen_{x}.py") for x in generators],
                     ucd_files_full))
 
         makefile.set_recipe(
                 result,
-                f'UCD_DIR="{UCD_DIR}" python3 {generator} > {result}')
+                f'mkdir -p {os.path.dirname(result)} && UCD_DIR="{UCD_DIR}" python3 {generator} > {result}')
 
 
         for ucd_file in ucd_files:
@@ -43,24 +71,85 @@ def get_lib_unicode(makefile, home, bin_dir):
             ucd_file_full = os.path.join(UCD_DIR, ucd_file)
             ucd_file_dir = os.path.dirname(ucd_file_full)
 
+            # the DUCET is published with UTS #10 rather than with the UCD,
+            # the confusables with UTS #39 and the emoji sequences with UTS #51
+            if ucd_file == "allkeys.txt":
+                url = f"https://www.unicode.org/Public/UCA/latest/{ucd_file}"
+            elif ucd_file == "confusables.txt":
+                url = f"https://www.unicode.org/Public/security/latest/{ucd_file}"
+            elif ucd_file in ["emoji-sequences.txt", "emoji-zwj-sequences.txt"]:
+                url = f"https://www.unicode.org/Public/emoji/latest/{ucd_file}"
+            else:
+                url = f"https://www.unicode.org/Public/UCD/latest/ucd/{ucd_file}"
+
             makefile.set_recipe(
                     ucd_file_full,
-                    f"[ -f '{ucd_file_full}' ] || (mkdir -p '{ucd_file_dir}' && cd '{ucd_file_dir}' && wget 'https://www.unicode.org/Public/UCD/latest/ucd/{ucd_file}')")
-
-    def add_codegen_src(name, ucd_files):
+                    f"[ -f '{ucd_file_full}' ] || (mkdir -p '{ucd_file_dir}' && cd '{ucd_file_dir}' && wget '{url}')")
+
+    # the Latin-1 fast paths, which unicode.hpp includes
+    latin1_generators = [
+            "general_category",
+            "simple_property",
+            "east_asian_width",
+            "line_break_property",
+            "script",
+            "bidi_class",
+            "display_width"]
+    latin1_header = os.path.join(include, "auto_latin1.hpp")
+    cpp_helper.generated_files.add(latin1_header)
+    add_codegen(
+            os.path.join(codegen, "gen_latin1.py"),
+            latin1_header,
+            ["UnicodeData.txt", "PropList.txt", "emoji/emoji-data.txt", "EastAsianWidth.txt",
+                "LineBreak.txt", "Scripts.txt", "HangulSyllableType.txt", "DerivedCoreProperties.txt",
+                "extracted/DerivedBidiClass.txt"],
+            generators=latin1_generators)
+
+    # the optional binary property database, the tests load it from here
+    property_db = os.path.join(bin_dir, "lib_unicode", "unicode_properties.db")
+    add_codegen(
+            os.path.join(codegen, "gen_property_db.py"),
+            property_db,
+            ["UnicodeData.txt", "PropList.txt", "emoji/emoji-data.txt", "EastAsianWidth.txt",
+                "LineBreak.txt", "Scripts.txt", "HangulSyllableType.txt", "DerivedCoreProperties.txt"],
+            generators=latin1_generators)
+    makefile.add_prerequisite(os.path.join(bin_dir, "lib_unicode", "lib_unicode_test"), property_db)
+
+    def add_codegen_src(name, ucd_files, headers=["unicode.hpp"], generators=[]):
         nonlocal l, add_codegen, codegen, src
         generator = os.path.join(codegen, f"gen_{name}.py")
         result = os.path.join(src, f"auto_{name}.cpp")
-        add_codegen(generator, result, ucd_files)
-        l.add_source_file(result, headers=[os.path.join(include, "unicode.hpp")])
+        add_codegen(generator, result, ucd_files, generators)
+        l.add_source_file(result, headers=[os.path.join(include, x) for x in headers] + [latin1_header])
 
     add_codegen_src("general_category",        ["UnicodeData.txt"                     ])
     add_codegen_src("hangul_syllable_type",    ["HangulSyllableType.txt"              ])
     add_codegen_src("indic_syllabic_category", ["IndicSyllabicCategory.txt"           ])
     add_codegen_src("line_break_property",     ["LineBreak.txt"                       ])
     add_codegen_src("script",                  ["Scripts.txt"                         ])
-    add_codegen_src("simple_property",         ["PropList.txt", "emoji/emoji-data.txt"])
+    add_codegen_src("bidi_class",              ["extracted/DerivedBidiClass.txt"      ])
+    add_codegen_src("simple_property",         ["PropList.txt", "emoji/emoji-data.txt", "DerivedCoreProperties.txt"])
     add_codegen_src("east_asian_width",        ["EastAsianWidth.txt"                    ])
+    add_codegen_src("case_mapping",            ["UnicodeData.txt", "SpecialCasing.txt", "CaseFolding.txt"])
+    add_codegen_src("normalization",           ["UnicodeData.txt", "DerivedNormalizationProps.txt"],
+            headers=["unicode.hpp", "unicode_normalization.hpp"])
+    add_codegen_src("collation",               ["allkeys.txt"],
+            headers=["unicode.hpp", "unicode_collation.hpp"])
+    add_codegen_src("search_folding",          ["UnicodeData.txt", "SpecialCasing.txt", "CaseFolding.txt"],
+            headers=["unicode.hpp", "unicode_search.hpp"],
+            generators=["case_mapping", "general_category", "normalization"])
+    add_codegen_src("script_extensions",       ["ScriptExtensions.txt", "Scripts.txt", "PropertyValueAliases.txt"],
+            headers=["unicode.hpp", "unicode_script_runs.hpp"])
+    add_codegen_src("bidi_brackets",           ["BidiBrackets.txt", "BidiMirroring.txt", "UnicodeData.txt"],
+            headers=["unicode.hpp", "unicode_bidi.hpp"])
+    add_codegen_src("names",                   ["UnicodeData.txt"],
+            headers=["unicode.hpp", "unicode_names.hpp"])
+    add_codegen_src("confusables",             ["confusables.txt"],
+            headers=["unicode.hpp", "unicode_confusables.hpp"])
+    add_codegen_src("emoji_sequences",         ["emoji-sequences.txt", "emoji-zwj-sequences.txt"],
+            headers=["unicode.hpp", "unicode_emoji.hpp"])
+    add_codegen_src("display_width",           ["UnicodeData.txt", "EastAsianWidth.txt", "HangulSyllableType.txt",
+                                                "DerivedCoreProperties.txt", "PropList.txt"])
 
     def add_codegen_test(name, ucd_files):
         nonlocal l, add_codegen, codegen, test
@@ -76,6 +165,9 @@ def get_lib_unicode(makefile, home, bin_dir):
     add_codegen_test("sentence_break_property",         ["auxiliary/SentenceBreakProperty.txt" ])
     add_codegen_test("simple_property",                 ["PropList.txt", "emoji/emoji-data.txt"])
     add_codegen_test("east_asian_width",                ["EastAsianWidth.txt"                  ])
+    add_codegen_test("case_mapping",                    ["UnicodeData.txt", "CaseFolding.txt"  ])
+    add_codegen_test("bidi_class",                      ["extracted/DerivedBidiClass.txt"      ])
+    add_codegen_test("normalization",                   ["NormalizationTest.txt"               ])
 
     return l
 
@@ -139,22 +231,40 @@ def get_lib_twig(makefile, home, bin_dir,
     for name in [
             "twig_color",
             "twig_curses",
-            "twig_os_linux"
+            "twig_event_loop_linux",
+            "twig_input",
+            "twig_os_linux",
+            "twig_terminal",
+            "twig_text_width"
             ]:
         lib.add_source_file(os.path.join(home, "src", f"{name}.cpp"))
 
     for name in [
+            "frame_scheduler",
+            "input",
+            "widget_list",
             ]:
         lib.add_cxxtest_suite(os.path.join(home, "test", f"test_{name}.hpp"))
 
     return lib
 
 
-def get_main_project(makefile, home, bin_dir):
-    lib_unicode = get_lib_unicode(makefile, os.path.join(home, "lib_unicode"), bin_dir)
-    lib_encoding = get_lib_encoding(makefile, os.path.join(home, "lib_encoding"), bin_dir, lib_unicode)
-    lib_capstone = get_lib_capstone(makefile, os.path.join(home, "lib_capstone"), bin_dir, lib_unicode, lib_encoding)
-    lib_twig = get_lib_twig(makefile, os.path.join(home, "lib_twig"), bin_dir, lib_unicode, lib_encoding)
+def get_lib_unicode_bench(makefile, home, bin_dir,
+        lib_unicode, lib_encoding):
+
+    # Lookups timed at -Og say little about the table layout, so the
+    # benchmark has its own -O2 build of the libraries.
+    bench = CxxProject("lib_unicode_bench", bin_dir, executable=True, optimization="-O2")
+    bench.add_sources_of(lib_unicode)
+    bench.add_sources_of(lib_encoding)
+
+    bench.add_source_file(os.path.join(home, "bench", "bench_lookup.cpp"))
+
+    return bench
+
+
+def get_main_project(makefile, home, bin_dir,
+        lib_unicode, lib_encoding, lib_capstone, lib_twig):
 
     proj = CxxProject("hottellbt_capstone", bin_dir, executable=True)
     proj.add_subproject(lib_unicode)
@@ -171,11 +281,30 @@ def get_main_project(makefile, home, bin_dir):
 
 
 def configure(makefile, home, bin_dir):
-    main_project = get_main_project(makefile, home, bin_dir)
+    lib_unicode = get_lib_unicode(makefile, os.path.join(home, "lib_unicode"), bin_dir)
+    lib_encoding = get_lib_encoding(makefile, os.path.join(home, "lib_encoding"), bin_dir, lib_unicode)
+    lib_capstone = get_lib_capstone(makefile, os.path.join(home, "lib_capstone"), bin_dir, lib_unicode, lib_encoding)
+    lib_twig = get_lib_twig(makefile, os.path.join(home, "lib_twig"), bin_dir, lib_unicode, lib_encoding)
+
+    main_project = get_main_project(makefile, home, bin_dir,
+            lib_unicode, lib_encoding, lib_capstone, lib_twig)
     main_project.configure(makefile)
 
+    bench = get_lib_unicode_bench(makefile, os.path.join(home, "lib_unicode"), bin_dir,
+            lib_unicode, lib_encoding)
+    bench.configure(makefile)
+
     # special recipes
     makefile.add_rule("clean", recipe=f"find {bin_dir} -type f | xargs rm", phony=True)
     makefile.add_rule("run", prerequisites=[main_project.executable_path], recipe=f"./{main_project.executable_path}", phony=True)
     makefile.add_rule("test", recipe='@for x in $^ ; do echo "$$x" && ./"$$x" ; done', phony=True)
 
+    # lookup timings and table sizes, as CSV, kept next to the benchmark so
+    # that they can be compared between builds
+    bench_dir = os.path.dirname(bench.executable_path)
+    table_sizes = os.path.join(home, "lib_unicode", "bench", "table_sizes.py")
+    makefile.add_rule("bench", prerequisites=[bench.executable_path], recipe=[
+        f"./{bench.executable_path} | tee {os.path.join(bench_dir, 'lookups.csv')}",
+        f"python3 {table_sizes} {bench.executable_path} | tee {os.path.join(bench_dir, 'table_sizes.csv')}"],
+        phony=True)
+
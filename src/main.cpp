@@ -1,11 +1,15 @@
 #include <vector>
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <numeric>
 #include <exception>
 
 #include <cassert>
 #include <cstring>
 
 #include "unicode.hpp"
+#include "unicode_bidi.hpp"
 #include "encoding.hpp"
 
 #include "todo.hpp"
@@ -39,10 +43,10 @@ inline Unicode::string_t escape(const Unicode::string_t s) {
 class DemoListModel : public twig::widget::ListModel<todo::Item> {
 	public:
 		DemoListModel() {
-			items.push_back({});
-			items.push_back({});
-			items.push_back({});
-			items.push_back({});
+			push_back({});
+			push_back({});
+			push_back({});
+			push_back({});
 		}
 
 		std::vector<todo::Item> items;
@@ -51,6 +55,12 @@ class DemoListModel : public twig::widget::ListModel<todo::Item> {
 
 		todo::Item get_element(size_t idx) { return items[idx]; }
 
+		void visit_range(size_t first, size_t end, const Visitor& visit) override {
+			for (size_t idx = first; idx < end; idx++) {
+				visit(idx, items[idx]);
+			}
+		}
+
 		todo::Item* get_element_ptr(size_t idx) { return &items[idx]; }
 
 		void erase(const size_t erase_idx) {
@@ -61,23 +71,115 @@ class DemoListModel : public twig::widget::ListModel<todo::Item> {
 					|| (get_selection_index() == num_elements() - 1 && get_selection_index() > 0)) {
 				set_selection_index(get_selection_index() - 1);
 			}
+			// the one item it looked like, wherever it is, stops being a duplicate
+			const bool had_one_duplicate = skeletons.count(items[erase_idx].get_skeleton()) == 2;
+
+			skeletons.remove(items[erase_idx]);
 			items.erase(items.begin() + erase_idx);
+
+			// the rows below move up, and the last one is left empty
+			if (had_one_duplicate) {
+				invalidate_all();
+			} else {
+				invalidate_rows(erase_idx, items.size() + 1);
+			}
+			scroll_to_selection();
 		}
 
 		void push_back(const todo::Item& item) {
 			items.push_back(item);
+			if (add_skeleton(item)) {
+				invalidate_all();
+			} else {
+				invalidate_rows(items.size() - 1, items.size());
+			}
 		}
 
 		void insert(const size_t idx, const todo::Item& item) {
 			items.insert(items.begin() + idx, item);
+			if (add_skeleton(item)) {
+				invalidate_all();
+			} else {
+				invalidate_rows(idx, items.size());
+			}
+		}
+
+		// all at once, so that the rows after idx move only once
+		void insert_all(const size_t idx, std::vector<todo::Item>&& new_items) {
+			// a row above idx may have just gotten a look-alike
+			bool new_duplicate = false;
+			for (const todo::Item& item : new_items) {
+				new_duplicate |= add_skeleton(item);
+			}
+			items.insert(items.begin() + idx,
+					std::make_move_iterator(new_items.begin()),
+					std::make_move_iterator(new_items.end()));
+
+			if (new_duplicate) {
+				invalidate_all();
+			} else {
+				invalidate_rows(idx, items.size());
+			}
+		}
+
+		// Titles go through here, to keep the skeleton index up to date.
+		// Any other row may start or stop looking like this one, so all of
+		// them are repainted.
+		void set_title(const size_t idx, const Unicode::string_t& title) {
+			skeletons.remove(items[idx]);
+			items[idx].set_title(title);
+			skeletons.add(items[idx]);
+			invalidate_all();
+		}
+
+		void set_status(const size_t idx, todo::Status status) {
+			items[idx].status = status;
+			invalidate_rows(idx, idx + 1);
+		}
+
+		// whether another item has a title that looks the same, such as
+		// one spelled with Cyrillic letters that look like Latin ones
+		bool has_duplicate(const todo::Item& item) const {
+			return skeletons.has_duplicate(item);
+		}
+
+		// the selection stays on the same item, wherever it ends up
+		void sort_by_title() {
+			if (items.empty()) return;
+
+			std::vector<size_t> order(items.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+				return todo::compare_titles(items[a], items[b]);
+			});
+
+			std::vector<todo::Item> sorted;
+			sorted.reserve(items.size());
+			size_t selection = 0;
+			for (size_t i = 0; i < order.size(); i++) {
+				if (order[i] == get_selection_index()) selection = i;
+				sorted.push_back(std::move(items[order[i]]));
+			}
+			items = std::move(sorted);
+
+			invalidate_all();
+			set_selection_index(selection);
 		}
 
 	private:
+		todo::SkeletonIndex skeletons;
+
+		// Returns whether the item is the first look-alike of another,
+		// which is then underlined too, wherever its row is
+		bool add_skeleton(const todo::Item& item) {
+			skeletons.add(item);
+			return skeletons.count(item.get_skeleton()) == 2;
+		}
 };
 
 class DemoListPainter : public twig::widget::ListPainter<todo::Item> {
 	public:
-		DemoListPainter(twig::widget::ListModel<todo::Item> *model) : ListPainter(model) {}
+		DemoListPainter(DemoListModel *model) : ListPainter(model), demo_model(model) {}
 
 	protected:
 		void draw_row(
@@ -86,6 +188,9 @@ class DemoListPainter : public twig::widget::ListPainter<todo::Item> {
 				const todo::Item& value,
 				size_t index,
 				bool selected) override;
+
+	private:
+		DemoListModel* const demo_model;
 };
 
 void DemoListPainter::draw_row(
@@ -135,8 +240,21 @@ void DemoListPainter::draw_row(
 		else x += 2;
 	}
 
-	g->add_unicode_str(value.title);
-	x += g->get_str_width(value.title);
+	// Titles with RTL text are painted in visual order, since the
+	// terminal shows codepoints as they come. That order only depends on
+	// the title, so the version of the title names it just as well.
+	const twig::text::RenderText& title = g->get_render_text(
+			value.get_title_version(),
+			value.get_visual_title());
+
+	// titles that look like another one are underlined
+	const bool duplicate = demo_model->has_duplicate(value);
+	if (duplicate) g->set_underline(true);
+
+	g->add_render_text(title);
+	x += title.width;
+
+	if (duplicate) g->set_underline(false);
 
 	for (; x < bounds.width; x++) {
 		g->add_ch(' ');
@@ -166,6 +284,8 @@ class MyTwigApp : public twig::TwigApp {
 
 		void when_typed_special(const twig::special_key& key) override;
 
+		void when_pasted(const Unicode::string_t& text) override;
+
 	private:
 		bool running = true;
 
@@ -206,26 +326,66 @@ void MyTwigApp::when_typed(const Unicode::codepoint_t& key) {
 			if (!list_model->is_empty())
 				list_model->erase(list_model->get_selection_index());
 			return;
+		case 's':
+			list_model->sort_by_title();
+			return;
 		case ']':
 			if (list_model->is_empty()) break;
-			item = list_model->get_element_ptr(list_model->get_selection_index());
-			item->status = todo::Status::IN_PROGRESS;
+			list_model->set_status(list_model->get_selection_index(), todo::Status::IN_PROGRESS);
 			return;
 		case 'c':
 			if (list_model->is_empty()) break;
 			item = list_model->get_element_ptr(list_model->get_selection_index());
-			std::string encoded = encoding::encode(encoding::Encoding::UTF8, item->title);
+			std::string encoded = encoding::encode(encoding::Encoding::UTF8, item->get_title());
 			std::string new_name = twig::os::subprocess::open_editor_line(encoded.c_str());
 			auto decoded = encoding::decode(encoding::Encoding::UTF8, new_name.c_str(), new_name.size());
-			item->title = escape(decoded);
+			list_model->set_title(list_model->get_selection_index(), escape(decoded));
+
+			// the editor had the whole screen
+			list_view->invalidate();
 			return;
 	}
 
 	list_controller->when_typed(key);
 }
 
+// Every line that was pasted is an item of its own. Control characters,
+// such as escape sequences that were copied along, would end up on the
+// terminal, so they are dropped.
+void MyTwigApp::when_pasted(const Unicode::string_t& text) {
+	std::vector<todo::Item> new_items;
+
+	Unicode::string_t line;
+	for (size_t i = 0; i <= text.size(); i++) {
+		if (i == text.size() || text[i] == '\n' || text[i] == '\r') {
+			if (!line.empty()) {
+				new_items.emplace_back(line);
+				line.clear();
+			}
+		} else if (text[i] == '\t') {
+			line.push_back(' ');
+		} else if (Unicode::get_general_category(text[i]) != Unicode::GeneralCategory::Cc) {
+			line.push_back(text[i]);
+		}
+	}
+
+	if (new_items.empty()) return;
+
+	const size_t count = new_items.size();
+	const size_t idx = list_model->is_empty() ? 0 : list_model->get_selection_index() + 1;
+	list_model->insert_all(idx, std::move(new_items));
+	list_model->set_selection_index(idx + count - 1);
+}
+
 int main() {
 	MyTwigApp app;
+
+	// TWIG_BACKEND=term draws straight to the terminal, without ncurses
+	const char* backend = twig::os::getenv("TWIG_BACKEND");
+	if (backend != nullptr && std::strcmp(backend, "term") == 0) {
+		return twig::term::run_twig_app(&app);
+	}
+
 	return twig::curses::run_twig_app(&app);
 }
 